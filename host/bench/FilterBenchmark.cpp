@@ -0,0 +1,112 @@
+#include "HostBenchmark.h"
+#include "Filter.h"
+#include "SortedMedian.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr size_t Iterations = 1000000;
+    constexpr size_t NumberOfSamples = 4096;
+
+    std::vector<float> getNoise()
+    {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+        std::vector<float> samples(NumberOfSamples);
+        std::generate(samples.begin(), samples.end(), [&]() { return distribution(generator); });
+        return samples;
+    }
+
+    template<typename Filter> double measureFilter(Filter& filter, const std::vector<float>& samples)
+    {
+        return measureTime([&](size_t iteration)
+        {
+            filter.calculate(samples[iteration % NumberOfSamples]);
+            keepResult(filter.getValue());
+        }, Iterations);
+    }
+} // namespace
+
+/*
+compare the heap-based moving median with the sorted vector at several window sizes
+*/
+void benchmarkMedian()
+{
+    const auto samples = getNoise();
+    for(size_t windowSize : {5, 15, 63, 255, 1023})
+    {
+        FilterMM heapMedian(windowSize);
+        SortedMedian sortedMedian(windowSize);
+        std::string name = "median " + std::to_string(windowSize);
+        displayTime(name + " heaps", measureFilter(heapMedian, samples));
+        displayTime(name + " sorted vector", measureFilter(sortedMedian, samples));
+    }
+    FilterMovingMedian<float, 15> fixedMedian;
+    displayTime("median 15 heaps, fixed size", measureFilter(fixedMedian, samples));
+}
+
+namespace
+{
+    constexpr size_t BlockSize = 64;
+    constexpr size_t BlockIterations = Iterations / BlockSize;
+
+    // mean time per sample of the scalar path and of the block path of the filter [ns]
+    template<typename T, typename Filter> void benchmarkBlockPath(const std::string& name, Filter& filter, const std::vector<T>& samples)
+    {
+        displayTime(name + " scalar", measureTime([&](size_t iteration)
+        {
+            filter.calculate(samples[iteration % NumberOfSamples]);
+            keepResult(filter.getValue());
+        }, Iterations));
+        displayTime(name + " block", measureTime([&](size_t iteration)
+        {
+            size_t index = (iteration * BlockSize) % NumberOfSamples;
+            filter.calculate(mbed::Span<const T>(&samples[index], BlockSize));
+            keepResult(filter.getValue());
+        }, BlockIterations) / BlockSize);
+    }
+} // namespace
+
+/*
+compare the scalar and the block paths of the smoothing filters
+the block times are divided by the samples or scans of a block, so both paths show the cost per sample
+*/
+void benchmarkSmoothing()
+{
+    const auto samples = getNoise();
+    std::vector<int16_t> integerSamples(NumberOfSamples);
+    std::transform(samples.begin(), samples.end(), integerSamples.begin(), [](float sample) { return static_cast<int16_t>(sample * 2000.0F); });
+
+    // the windows are longer than the blocks, so the block path updates the window sums instead of summing the last window
+    FilterMovingAverage<int16_t, 128> integerSma;
+    benchmarkBlockPath("SMA int16 128", integerSma, integerSamples);
+    FilterMovingAverage<float, 128> floatSma;
+    benchmarkBlockPath("SMA float 128", floatSma, samples);
+    FilterSMA dynamicSma(100);
+    benchmarkBlockPath("SMA float 100 dynamic", dynamicSma, samples);
+    FilterEMA ema(0.05F);
+    benchmarkBlockPath("EMA", ema, samples);
+
+    // six potentiometer channels interleaved in scans
+    constexpr size_t Channels = 6;
+    constexpr size_t ScansPerBlock = BlockSize / Channels;
+    std::vector<FilterEMA> channelFilters(Channels, FilterEMA(0.05F));
+    displayTime("EMA 6 channel filters per scan", measureTime([&](size_t iteration)
+    {
+        size_t index = (iteration * Channels) % (NumberOfSamples - Channels);
+        for(size_t channel = 0; channel < Channels; channel++)
+        {
+            channelFilters[channel].calculate(samples[index + channel]);
+        }
+        keepResult(channelFilters[0].getValue());
+    }, Iterations));
+    FilterEMABank<Channels> bank(0.05F);
+    displayTime("EMA 6 channel bank per scan", measureTime([&](size_t iteration)
+    {
+        size_t index = (iteration * ScansPerBlock * Channels) % (NumberOfSamples - ScansPerBlock * Channels);
+        bank.calculate(mbed::Span<const float>(&samples[index], ScansPerBlock * Channels));
+        keepResult(bank.getValues());
+    }, BlockIterations) / ScansPerBlock);
+}
@@ -0,0 +1,10 @@
+#include "HostBenchmark.h"
+
+int main()
+{
+    benchmarkMath();
+    benchmarkOrientation();
+    benchmarkMedian();
+    benchmarkSmoothing();
+    return 0;
+}
@@ -0,0 +1,43 @@
+#ifndef HOST_BENCHMARK_H_
+#define HOST_BENCHMARK_H_
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/*
+host timing of the firmware algorithms
+the host times do not replace the cycle counts measured on target, but show the relative cost of the variants
+*/
+
+// keeps the benchmarked result alive, so the compiler cannot remove the calculation
+template<typename T> void keepResult(const T& result)
+{
+    asm volatile("" : : "g"(&result) : "memory");
+}
+
+// returns the mean time of one call of the function [ns]
+template<typename Function> double measureTime(Function function, size_t iterations)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(size_t iteration = 0; iteration < iterations; iteration++)
+    {
+        function(iteration);
+    }
+    std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / static_cast<double>(iterations);
+}
+
+inline void displayTime(const std::string& name, double time)
+{
+    std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(1) << std::setw(10) << time << " ns" << std::endl;
+}
+
+// benchmark sections
+void benchmarkMath();
+void benchmarkOrientation();
+void benchmarkMedian();
+void benchmarkSmoothing();
+
+#endif /* HOST_BENCHMARK_H_ */
@@ -0,0 +1,70 @@
+#include "HostBenchmark.h"
+#include "Convert.h"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr size_t Iterations = 10000000;
+    constexpr size_t NumberOfInputs = 4096;
+    constexpr float PI = 3.14159265F;
+
+    // inputs spread evenly over the range <min,max>; precomputed, so the input generation is not measured
+    std::vector<float> getInputs(float min, float max)
+    {
+        std::vector<float> inputs(NumberOfInputs);
+        for(size_t index = 0; index < NumberOfInputs; index++)
+        {
+            inputs[index] = min + (max - min) * static_cast<float>(index) / static_cast<float>(NumberOfInputs - 1);
+        }
+        return inputs;
+    }
+
+    template<typename FastFunction, typename LibraryFunction>
+    void benchmarkFunction(const std::string& name, const std::vector<float>& inputs, FastFunction fastFunction, LibraryFunction libraryFunction)
+    {
+        displayTime(name, measureTime([&](size_t iteration) { keepResult(fastFunction(inputs[iteration % NumberOfInputs])); }, Iterations));
+        displayTime(name + " libm", measureTime([&](size_t iteration) { keepResult(libraryFunction(inputs[iteration % NumberOfInputs])); }, Iterations));
+    }
+} // namespace
+
+/*
+compare the fast math kernels of Convert with the standard library functions
+the accuracy of the kernels is verified by ConvertTest
+*/
+void benchmarkMath()
+{
+    const auto angles = getInputs(-4.0F * PI, 4.0F * PI);
+    benchmarkFunction("fastSin", angles, fastSin, [](float angle) { return std::sin(angle); });
+    benchmarkFunction("fastCos", angles, fastCos, [](float angle) { return std::cos(angle); });
+
+    // atan2 over the full circle
+    const auto circleAngles = getInputs(-PI, PI);
+    std::vector<float> sines(NumberOfInputs);
+    std::vector<float> cosines(NumberOfInputs);
+    for(size_t index = 0; index < NumberOfInputs; index++)
+    {
+        sines[index] = std::sin(circleAngles[index]);
+        cosines[index] = std::cos(circleAngles[index]);
+    }
+    displayTime("fastAtan2", measureTime([&](size_t iteration)
+    {
+        size_t index = iteration % NumberOfInputs;
+        keepResult(fastAtan2(sines[index], cosines[index]));
+    }, Iterations));
+    displayTime("fastAtan2 libm", measureTime([&](size_t iteration)
+    {
+        size_t index = iteration % NumberOfInputs;
+        keepResult(std::atan2(sines[index], cosines[index]));
+    }, Iterations));
+
+    benchmarkFunction("fastAsin", getInputs(-1.0F, 1.0F), fastAsin, [](float value) { return std::asin(value); });
+
+    // reciprocal square root over the range <1e-6,1e6> with logarithmic distribution
+    auto logInputs = getInputs(-6.0F, 6.0F);
+    for(auto& input : logInputs)
+    {
+        input = std::pow(10.0F, input);
+    }
+    benchmarkFunction("fastInvSqrt", logInputs, fastInvSqrt, [](float value) { return 1.0F / std::sqrt(value); });
+}
@@ -0,0 +1,58 @@
+#include "HostBenchmark.h"
+#include "Orientation.h"
+#include <array>
+#include <cmath>
+
+namespace
+{
+    constexpr size_t Iterations = 1000000;
+    constexpr size_t NumberOfSamples = 1000;
+    constexpr float DeltaT = 0.001F;
+    constexpr float TimeConstant = 0.5F;
+
+    // gyroscope and accelerometer samples of a slow pitch and roll motion
+    struct Samples
+    {
+        std::array<Vector3D<float>, NumberOfSamples> angularRate;
+        std::array<Vector3D<float>, NumberOfSamples> acceleration;
+        Samples()
+        {
+            for(size_t index = 0; index < NumberOfSamples; index++)
+            {
+                float phase = static_cast<float>(index) * 0.00628F;
+                angularRate[index] = {0.2F * std::cos(phase), 0.3F * std::sin(phase), 0.01F};
+                acceleration[index] = {0.1F * std::sin(phase), 0.2F * std::cos(phase), 0.97F};
+            }
+        }
+    };
+
+    template<typename Engine> void benchmarkEngine(const std::string& name, Engine& engine, const Samples& samples)
+    {
+        displayTime(name + " update", measureTime([&](size_t iteration)
+        {
+            size_t index = iteration % NumberOfSamples;
+            engine.update(samples.angularRate[index], samples.acceleration[index], DeltaT);
+        }, Iterations));
+        displayTime(name + " readout", measureTime([&](size_t iteration)
+        {
+            float sinYaw{0.0F};
+            float cosYaw{0.0F};
+            engine.setYawReference(static_cast<float>(iteration & 0xFFU) * 0.001F);
+            engine.getYawSinCos(sinYaw, cosYaw);
+            keepResult(engine.getPitch() + engine.getRoll() + engine.getYaw() + sinYaw + cosYaw);
+        }, Iterations));
+    }
+} // namespace
+
+/*
+compare the update and readout time of the orientation engines
+the readout includes setting the yaw reference, as the handler does once per frame
+*/
+void benchmarkOrientation()
+{
+    const Samples samples;
+    ComplementaryFilter complementaryFilter(TimeConstant);
+    benchmarkEngine("complementary filter", complementaryFilter, samples);
+    MahonyFilter mahonyFilter(TimeConstant);
+    benchmarkEngine("Mahony filter", mahonyFilter, samples);
+}
@@ -0,0 +1,56 @@
+#ifndef MBED_PLATFORM_SPAN_H_
+#define MBED_PLATFORM_SPAN_H_
+
+#include <cassert>
+#include <cstddef>
+
+/*
+host replacement of mbed::Span
+the subset of the mbed platform Span used by the firmware core; a view of a contiguous sequence of elements
+*/
+#define SPAN_DYNAMIC_EXTENT -1      //NOLINT(cppcoreguidelines-macro-usage)
+
+namespace mbed
+{
+
+template<typename ElementType, ptrdiff_t Extent = SPAN_DYNAMIC_EXTENT> class Span
+{
+public:
+    using index_type = ptrdiff_t;               //NOLINT(readability-identifier-naming)
+    using element_type = ElementType;           //NOLINT(readability-identifier-naming)
+    using pointer = ElementType*;               //NOLINT(readability-identifier-naming)
+    using reference = ElementType&;             //NOLINT(readability-identifier-naming)
+    using iterator = ElementType*;              //NOLINT(readability-identifier-naming)
+
+    Span() = default;
+    Span(pointer first, index_type count) : elements(first), count(count) { assert(count >= 0); }
+    Span(pointer first, pointer last) : elements(first), count(last - first) { assert(count >= 0); }
+    template<size_t Count> Span(element_type (&array)[Count]) : elements(array), count(Count) {}     //NOLINT(hicpp-avoid-c-arrays,modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays,google-explicit-constructor,hicpp-explicit-conversions)
+    // conversion from the span of the non-const elements
+    template<typename OtherElementType, ptrdiff_t OtherExtent>
+    Span(const Span<OtherElementType, OtherExtent>& other) : elements(other.data()), count(other.size()) {}     //NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+
+    index_type size() const { return count; }
+    bool empty() const { return count == 0; }
+    pointer data() const { return elements; }
+    reference operator[](index_type index) const { assert((index >= 0) && (index < count)); return elements[index]; }
+    iterator begin() const { return elements; }
+    iterator end() const { return elements + count; }
+    Span<element_type> first(index_type first) const { assert(first <= count); return Span<element_type>(elements, first); }
+    Span<element_type> last(index_type last) const { assert(last <= count); return Span<element_type>(elements + count - last, last); }
+    Span<element_type> subspan(index_type offset, index_type subCount = SPAN_DYNAMIC_EXTENT) const
+    {
+        assert(offset <= count);
+        return Span<element_type>(elements + offset, (subCount == SPAN_DYNAMIC_EXTENT) ? count - offset : subCount);
+    }
+private:
+    pointer elements{nullptr};
+    index_type count{0};
+};
+
+template<typename T> Span<T> make_Span(T* elements, ptrdiff_t count) { return Span<T>(elements, count); }     //NOLINT(readability-identifier-naming)
+template<typename T> Span<const T> make_const_Span(const T* elements, ptrdiff_t count) { return Span<const T>(elements, count); }     //NOLINT(readability-identifier-naming)
+
+} // namespace mbed
+
+#endif /* MBED_PLATFORM_SPAN_H_ */
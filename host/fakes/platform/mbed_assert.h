@@ -0,0 +1,11 @@
+#ifndef MBED_ASSERT_H
+#define MBED_ASSERT_H
+
+#include <cassert>
+
+/*
+host replacement of the mbed platform assert
+*/
+#define MBED_ASSERT(expr) assert(expr)      //NOLINT(cppcoreguidelines-macro-usage)
+
+#endif /* MBED_ASSERT_H */
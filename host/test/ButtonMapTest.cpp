@@ -0,0 +1,47 @@
+#include "ButtonMap.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+    constexpr std::array<ButtonMapping, 6> Mappings
+    {{
+        {0, 0, true},
+        {1, 1, true},
+        {2, 5, false},
+        {3, 6, true},
+        {9, 2, false},
+        {13, 31, true}
+    }};
+    constexpr auto Table = makeButtonMapTable(Mappings);
+
+    // reference mapping of one bit at a time
+    uint32_t mapBits(uint32_t inputs)
+    {
+        uint32_t buttons = 0;
+        for(const auto& mapping : Mappings)
+        {
+            uint32_t level = (inputs >> mapping.input) & 1U;
+            if((level ^ (mapping.isActiveLow ? 1U : 0U)) != 0)
+            {
+                buttons |= 1U << mapping.button;
+            }
+        }
+        return buttons;
+    }
+} // namespace
+
+TEST(ButtonMapTest, MergesMappingsOfTheSameShift)
+{
+    // shifts 0, 3, -7 and 18
+    EXPECT_EQ(Table.numberOfGroups, 4U);
+}
+
+TEST(ButtonMapTest, MatchesBitByBitMapping)
+{
+    uint32_t inputs = 0x12345678U;
+    for(int step = 0; step < 10000; step++)
+    {
+        inputs = inputs * 1664525U + 1013904223U;
+        ASSERT_EQ(Table.map(inputs & 0xFFFFU), mapBits(inputs & 0xFFFFU)) << "inputs = " << (inputs & 0xFFFFU);
+    }
+}
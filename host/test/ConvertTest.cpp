@@ -0,0 +1,65 @@
+#include "Convert.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace
+{
+    constexpr double PI = 3.14159265358979;
+    constexpr int NumberOfPoints = 1000000;
+
+    // maximum absolute error of the function against the reference in the range <min,max>
+    template<typename Function, typename Reference> double getMaxError(Function function, Reference reference, double min, double max)
+    {
+        double maxError{0.0};
+        for(int point = 0; point <= NumberOfPoints; point++)
+        {
+            auto argument = static_cast<float>(min + (max - min) * point / NumberOfPoints);
+            maxError = std::max(maxError, std::fabs(function(argument) - reference(static_cast<double>(argument))));
+        }
+        return maxError;
+    }
+
+    double sinReference(double angle) { return std::sin(angle); }
+    double cosReference(double angle) { return std::cos(angle); }
+} // namespace
+
+TEST(ConvertTest, FastSinCosErrorWithinHalfTurn)
+{
+    EXPECT_LT(getMaxError(fastSin, sinReference, -PI, PI), 1e-5);
+    EXPECT_LT(getMaxError(fastCos, cosReference, -PI, PI), 1e-5);
+}
+
+TEST(ConvertTest, FastSinCosErrorInFullRange)
+{
+    EXPECT_LT(getMaxError(fastSin, sinReference, -100.0, 100.0), 2e-5);
+    EXPECT_LT(getMaxError(fastCos, cosReference, -100.0, 100.0), 2e-5);
+}
+
+TEST(ConvertTest, FastAsinError)
+{
+    EXPECT_LT(getMaxError(fastAsin, [](double value) { return std::asin(value); }, -1.0, 1.0), 1.4e-5);
+}
+
+TEST(ConvertTest, FastAtan2Error)
+{
+    double maxError{0.0};
+    for(int point = 0; point <= NumberOfPoints; point++)
+    {
+        double angle = -PI + 2.0 * PI * point / NumberOfPoints;
+        auto y = static_cast<float>(std::sin(angle));
+        auto x = static_cast<float>(std::cos(angle));
+        maxError = std::max(maxError, std::fabs(fastAtan2(y, x) - std::atan2(static_cast<double>(y), static_cast<double>(x))));
+    }
+    EXPECT_LT(maxError, 1.2e-5);
+}
+
+TEST(ConvertTest, FastInvSqrtRelativeError)
+{
+    double maxError{0.0};
+    for(int point = 1; point <= NumberOfPoints; point++)
+    {
+        auto value = static_cast<float>(std::pow(10.0, -6.0 + 12.0 * point / NumberOfPoints));
+        maxError = std::max(maxError, std::fabs(fastInvSqrt(value) * std::sqrt(static_cast<double>(value)) - 1.0));
+    }
+    EXPECT_LT(maxError, 5e-6);
+}
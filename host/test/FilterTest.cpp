@@ -0,0 +1,303 @@
+#include "Filter.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr size_t NumberOfSamples = 5000;
+
+    /*
+    moving median computed by sorting a copy of the window
+    the window starts filled with zeros like FilterMM, and the median of an even window is its upper middle value
+    */
+    template<typename T> class SortedWindowMedian
+    {
+    public:
+        explicit SortedWindowMedian(size_t size) : window(size, T{0}) {}
+        T calculate(T input)
+        {
+            window[headIndex] = input;
+            headIndex = (headIndex + 1) % window.size();
+            std::vector<T> sorted = window;
+            std::sort(sorted.begin(), sorted.end());
+            return sorted[sorted.size() / 2];
+        }
+    private:
+        std::vector<T> window;
+        size_t headIndex{0};
+    };
+
+    // random samples; the narrow range of the integer samples produces many equal values in the window
+    template<typename T> std::vector<T> getSamples(unsigned seed)
+    {
+        std::mt19937 generator(seed);
+        std::vector<T> samples(NumberOfSamples);
+        std::uniform_real_distribution<float> distribution(-100.0F, 100.0F);
+        std::uniform_int_distribution<int> integerDistribution(-8, 8);
+        for(auto& sample : samples)
+        {
+            sample = std::is_floating_point<T>::value ? static_cast<T>(distribution(generator)) : static_cast<T>(integerDistribution(generator));
+        }
+        return samples;
+    }
+
+    // compare the filter output with the reference after every sample; returns the index of the first mismatch or NumberOfSamples
+    template<typename T, typename Filter> size_t getFirstMismatch(Filter& filter, size_t size, const std::vector<T>& samples)
+    {
+        SortedWindowMedian<T> reference(size);
+        for(size_t index = 0; index < samples.size(); index++)
+        {
+            filter.calculate(samples[index]);
+            if(filter.getValue() != reference.calculate(samples[index]))
+            {
+                return index;
+            }
+        }
+        return samples.size();
+    }
+} // namespace
+
+TEST(FilterTest, DynamicMedianMatchesSortedWindow)
+{
+    for(size_t size : {1, 2, 3, 4, 5, 15, 16, 64, 255, 256, 257})
+    {
+        const auto floatSamples = getSamples<float>(static_cast<unsigned>(size));
+        FilterMM floatFilter(size);
+        EXPECT_EQ(getFirstMismatch(floatFilter, size, floatSamples), NumberOfSamples) << "window size " << size;
+        const auto integerSamples = getSamples<int16_t>(static_cast<unsigned>(size));
+        FilterMovingMedian<int16_t> integerFilter(size);
+        EXPECT_EQ(getFirstMismatch(integerFilter, size, integerSamples), NumberOfSamples) << "window size " << size;
+    }
+}
+
+TEST(FilterTest, FixedMedianMatchesSortedWindow)
+{
+    // the 256-slot window has the 8-bit heap indexes, the 257-slot window the 16-bit ones
+    FilterMovingMedian<float, 15> filter15;
+    EXPECT_EQ(getFirstMismatch(filter15, 15, getSamples<float>(15)), NumberOfSamples);
+    FilterMovingMedian<int16_t, 64> filter64;
+    EXPECT_EQ(getFirstMismatch(filter64, 64, getSamples<int16_t>(64)), NumberOfSamples);
+    FilterMovingMedian<float, 256> filter256;
+    EXPECT_EQ(getFirstMismatch(filter256, 256, getSamples<float>(256)), NumberOfSamples);
+    FilterMovingMedian<int16_t, 257> filter257;
+    EXPECT_EQ(getFirstMismatch(filter257, 257, getSamples<int16_t>(257)), NumberOfSamples);
+}
+
+TEST(FilterTest, MedianRejectsImpulses)
+{
+    FilterMovingMedian<float, 5> filter;
+    for(int sample = 0; sample < 10; sample++)
+    {
+        filter.calculate(1.0F);
+    }
+    // two impulses in a window of five do not reach the output
+    filter.calculate(1000.0F);
+    EXPECT_EQ(filter.getValue(), 1.0F);
+    filter.calculate(-1000.0F);
+    EXPECT_EQ(filter.getValue(), 1.0F);
+    filter.calculate(1.0F);
+    EXPECT_EQ(filter.getValue(), 1.0F);
+}
+
+namespace
+{
+    // block lengths shorter than, equal to and longer than the windows, so the block path wraps around the ring
+    const std::vector<size_t> BlockSizes{1, 3, 7, 15, 16, 17, 40, 2, 33, 64, 5};
+
+    // feed the samples to the filter in blocks of the BlockSizes lengths and call the check after every block
+    template<typename T, typename Filter, typename Check> void calculateInBlocks(Filter& filter, const std::vector<T>& samples, Check check)
+    {
+        size_t index = 0;
+        for(size_t block = 0; index < samples.size(); block++)
+        {
+            size_t blockSize = std::min(BlockSizes[block % BlockSizes.size()], samples.size() - index);
+            filter.calculate(mbed::Span<const T>(&samples[index], static_cast<ptrdiff_t>(blockSize)));
+            index += blockSize;
+            check(index);
+        }
+    }
+
+    // the value of the scalar path after the given number of samples
+    template<typename T, typename Filter> std::vector<decltype(std::declval<Filter>().getValue())> getScalarValues(Filter filter, const std::vector<T>& samples)
+    {
+        std::vector<decltype(filter.getValue())> scalarValues{filter.getValue()};
+        for(T sample : samples)
+        {
+            filter.calculate(sample);
+            scalarValues.push_back(filter.getValue());
+        }
+        return scalarValues;
+    }
+} // namespace
+
+TEST(FilterTest, IntegerSmaBlockPathMatchesScalarPath)
+{
+    const auto samples = getSamples<int16_t>(1);
+    FilterMovingAverage<int16_t, 16> fixedFilter;
+    const auto fixedValues = getScalarValues(fixedFilter, samples);
+    calculateInBlocks(fixedFilter, samples, [&](size_t count) { ASSERT_EQ(fixedFilter.getValue(), fixedValues[count]) << "after " << count << " samples"; });
+
+    FilterMovingAverage<int16_t> dynamicFilter(15);
+    const auto dynamicValues = getScalarValues(dynamicFilter, samples);
+    calculateInBlocks(dynamicFilter, samples, [&](size_t count) { ASSERT_EQ(dynamicFilter.getValue(), dynamicValues[count]) << "after " << count << " samples"; });
+}
+
+TEST(FilterTest, FloatSmaBlockPathMatchesScalarPath)
+{
+    // the block path sums in a different order, so the float results differ by the rounding only
+    const auto samples = getSamples<float>(2);
+    constexpr float Tolerance = 1e-3F;
+    FilterMovingAverage<float, 16> fixedFilter;
+    const auto fixedValues = getScalarValues(fixedFilter, samples);
+    calculateInBlocks(fixedFilter, samples, [&](size_t count) { ASSERT_NEAR(fixedFilter.getValue(), fixedValues[count], Tolerance) << "after " << count << " samples"; });
+
+    FilterSMA dynamicFilter(33);
+    const auto dynamicValues = getScalarValues(dynamicFilter, samples);
+    calculateInBlocks(dynamicFilter, samples, [&](size_t count) { ASSERT_NEAR(dynamicFilter.getValue(), dynamicValues[count], Tolerance) << "after " << count << " samples"; });
+}
+
+TEST(FilterTest, EmaBlockPathMatchesScalarPath)
+{
+    const auto samples = getSamples<float>(3);
+    FilterEMA filter(0.05F);
+    const auto scalarValues = getScalarValues(filter, samples);
+    calculateInBlocks(filter, samples, [&](size_t count) { ASSERT_FLOAT_EQ(filter.getValue(), scalarValues[count]) << "after " << count << " samples"; });
+}
+
+TEST(FilterTest, EmaBankMatchesChannelFilters)
+{
+    constexpr size_t Channels = 6;
+    constexpr float FilterFactor = 0.05F;
+    const auto scans = getSamples<float>(4);
+    FilterEMABank<Channels> bank(FilterFactor);
+    std::vector<FilterEMA> channelFilters(Channels, FilterEMA(FilterFactor));
+    // the samples are interleaved: scan by scan, every scan holds one sample of every channel
+    const size_t numberOfScans = scans.size() / Channels;
+    for(size_t scan = 0; scan < numberOfScans; scan += 3)
+    {
+        size_t blockScans = std::min<size_t>(3, numberOfScans - scan);
+        bank.calculate(mbed::Span<const float>(&scans[scan * Channels], static_cast<ptrdiff_t>(blockScans * Channels)));
+        for(size_t blockScan = scan; blockScan < scan + blockScans; blockScan++)
+        {
+            for(size_t channel = 0; channel < Channels; channel++)
+            {
+                channelFilters[channel].calculate(scans[blockScan * Channels + channel]);
+            }
+        }
+        for(size_t channel = 0; channel < Channels; channel++)
+        {
+            ASSERT_FLOAT_EQ(bank.getValue(channel), channelFilters[channel].getValue()) << "channel " << channel << " after scan " << scan;
+        }
+    }
+}
+
+namespace
+{
+    constexpr double TwoPI = 6.283185307179586;
+    constexpr float SampleRate = 1000.0F;
+
+    /*
+    steady-state response of the filter to a sine wave measured by the correlation over whole periods
+    the frequency must have a whole number of samples per period; the phase is relative to the input sine
+    */
+    template<typename Filter> std::complex<double> measureResponse(Filter filter, float frequency)
+    {
+        constexpr size_t SettlingSamples = 20000;
+        constexpr size_t MeasuredSamples = 10000;
+        std::complex<double> correlation{0.0, 0.0};
+        for(size_t index = 0; index < SettlingSamples + MeasuredSamples; index++)
+        {
+            double phase = TwoPI * frequency * static_cast<double>(index) / SampleRate;
+            filter.calculate(static_cast<float>(std::sin(phase)));
+            if(index >= SettlingSamples)
+            {
+                correlation += static_cast<double>(filter.getValue()) * std::polar(1.0, -phase);
+            }
+        }
+        // the sine is the imaginary part of the complex exponential, so the correlation is rotated by j
+        return correlation * std::complex<double>(0.0, 2.0 / MeasuredSamples);
+    }
+
+    double toDecibels(double gain) { return 20.0 * std::log10(gain); }
+
+    // group delay of the filter at the frequency from the phase slope of its response [s]
+    template<typename Filter> double getGroupDelay(const Filter& filter, float frequency)
+    {
+        constexpr float Step = 0.01F;
+        double phase1 = std::arg(filter.getResponse(frequency - Step, SampleRate));
+        double phase2 = std::arg(filter.getResponse(frequency + Step, SampleRate));
+        return -(phase2 - phase1) / (TwoPI * 2.0 * Step);
+    }
+} // namespace
+
+TEST(FilterTest, ButterworthLowPassIsDown3dBAtCutoff)
+{
+    // the product of the Butterworth quality factors is 1/sqrt(2), the gain of all sections at the cutoff frequency
+    constexpr float CutoffFrequency = 50.0F;
+    constexpr double Tolerance = 0.05;      // [dB]
+    FilterBiquad<2> filter;
+    filter.designLowPass(CutoffFrequency, SampleRate);
+    EXPECT_NEAR(toDecibels(std::abs(filter.getResponse(CutoffFrequency, SampleRate))), -3.0103, Tolerance);
+    EXPECT_NEAR(toDecibels(std::abs(measureResponse(filter, CutoffFrequency))), -3.0103, Tolerance);
+    // unity gain at DC and at least the 4th order roll-off of 24 dB per octave; the bilinear transform makes it steeper towards fs/2
+    EXPECT_NEAR(std::abs(filter.getResponse(0.0F, SampleRate)), 1.0, 1e-4);
+    EXPECT_LT(toDecibels(std::abs(filter.getResponse(4.0F * CutoffFrequency, SampleRate))), -48.0);
+}
+
+TEST(FilterTest, ButterworthHighPassBlocksDC)
+{
+    constexpr float CutoffFrequency = 50.0F;
+    FilterBiquad<2> filter;
+    filter.designHighPass(CutoffFrequency, SampleRate);
+    EXPECT_NEAR(std::abs(filter.getResponse(0.0F, SampleRate)), 0.0, 1e-4);
+    EXPECT_NEAR(toDecibels(std::abs(filter.getResponse(CutoffFrequency, SampleRate))), -3.0103, 0.05);
+    EXPECT_NEAR(std::abs(filter.getResponse(SampleRate / 2.0F, SampleRate)), 1.0, 1e-3);
+    // a constant input decays to zero
+    for(int sample = 0; sample < 2000; sample++)
+    {
+        filter.calculate(1.0F);
+    }
+    EXPECT_NEAR(filter.getValue(), 0.0F, 1e-4F);
+}
+
+TEST(FilterTest, NotchRemovesCenterFrequency)
+{
+    constexpr float CenterFrequency = 50.0F;
+    constexpr float Q = 5.0F;
+    FilterBiquad<1> filter;
+    filter.designNotch(CenterFrequency, SampleRate, Q);
+    // the depth of the measured notch is limited by the float rounding only
+    EXPECT_LT(toDecibels(std::abs(filter.getResponse(CenterFrequency, SampleRate))), -80.0);
+    EXPECT_LT(toDecibels(std::abs(measureResponse(filter, CenterFrequency))), -60.0);
+    // the -3 dB points are half of the bandwidth from the center frequency
+    EXPECT_NEAR(toDecibels(std::abs(filter.getResponse(CenterFrequency + CenterFrequency / Q / 2.0F, SampleRate))), -3.0103, 0.3);
+    // the frequencies away from the notch pass unchanged
+    EXPECT_NEAR(std::abs(measureResponse(filter, 5.0F)), 1.0, 2e-3);
+    EXPECT_NEAR(std::abs(measureResponse(filter, 250.0F)), 1.0, 2e-3);
+}
+
+TEST(FilterTest, LowPassGroupDelayMatchesButterworthPrototype)
+{
+    // the group delay of the analog section at DC is 1 / (Q * omega); the bilinear warping is negligible at fc << fs
+    constexpr float CutoffFrequency = 20.0F;
+    constexpr size_t Sections = 2;
+    FilterBiquad<Sections> filter;
+    filter.designLowPass(CutoffFrequency, SampleRate);
+    double prototypeDelay{0.0};
+    for(size_t section = 0; section < Sections; section++)
+    {
+        prototypeDelay += 1.0 / (getButterworthQ(section, Sections) * TwoPI * CutoffFrequency);
+    }
+    EXPECT_NEAR(getGroupDelay(filter, 0.5F), prototypeDelay, 0.02 * prototypeDelay);
+
+    // the phase slope of the filtered sine waves agrees with the response of the coefficients
+    std::complex<double> response1 = measureResponse(filter, 4.0F);
+    std::complex<double> response2 = measureResponse(filter, 5.0F);
+    double measuredDelay = -std::arg(response2 / response1) / TwoPI;
+    double responseDelay = -std::arg(filter.getResponse(5.0F, SampleRate) / filter.getResponse(4.0F, SampleRate)) / TwoPI;
+    EXPECT_NEAR(measuredDelay, responseDelay, 0.01 * responseDelay);
+}
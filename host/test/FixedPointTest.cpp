@@ -0,0 +1,119 @@
+#include "FixedPoint.h"
+#include "Orientation.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+namespace
+{
+    constexpr double PI = 3.14159265358979;
+
+    // angle difference with wrap-around [rad]
+    double angleError(int32_t binaryAngle, double expected)
+    {
+        double error = binaryAngleToRadians(binaryAngle) - expected;
+        return std::remainder(error, 2.0 * PI);
+    }
+} // namespace
+
+TEST(FixedPointTest, SqrtIsRoundedDown)
+{
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<uint32_t> distribution;
+    for(int step = 0; step < 100000; step++)
+    {
+        uint32_t value = distribution(generator);
+        auto expected = static_cast<uint32_t>(std::floor(std::sqrt(static_cast<double>(value))));
+        ASSERT_EQ(fixedSqrt(value), expected) << "value = " << value;
+    }
+    EXPECT_EQ(fixedSqrt(0), 0U);
+    EXPECT_EQ(fixedSqrt(0xFFFFFFFFU), 65535U);
+}
+
+TEST(FixedPointTest, Atan2Error)
+{
+    double maxError{0.0};
+    for(int step = 0; step < 3600; step++)
+    {
+        double angle = -PI + step * PI / 1800.0;
+        for(double radius : {100.0, 16384.0, 46000.0})
+        {
+            auto y = static_cast<int32_t>(std::lround(radius * std::sin(angle)));
+            auto x = static_cast<int32_t>(std::lround(radius * std::cos(angle)));
+            maxError = std::max(maxError, std::fabs(angleError(fixedAtan2(y, x), std::atan2(y, x))));
+        }
+    }
+    EXPECT_LT(maxError, 4e-5);
+}
+
+TEST(FixedPointTest, SinCosError)
+{
+    double maxError{0.0};
+    for(int step = 0; step < 100000; step++)
+    {
+        double angle = -PI + step * 2.0 * PI / 100000.0;
+        int32_t binaryAngle = toBinaryAngle(static_cast<float>(angle));
+        double exactAngle = binaryAngleToRadians(binaryAngle);
+        maxError = std::max(maxError, std::fabs(fixedSin(binaryAngle) / Q15Scale - std::sin(exactAngle)));
+        maxError = std::max(maxError, std::fabs(fixedCos(binaryAngle) / Q15Scale - std::cos(exactAngle)));
+    }
+    EXPECT_LT(maxError, 1.6e-4);
+}
+
+TEST(FixedPointTest, ScaleAngleMatchesFloatScale)
+{
+    constexpr float MaxAngle = 0.9F;
+    const int32_t angleScale = axisScale(MaxAngle);
+    for(int step = -90; step <= 90; step++)
+    {
+        float angle = static_cast<float>(step) * 0.01F;
+        int16_t expected = scale<float, int16_t>(-MaxAngle, MaxAngle, angle, -32767, 32767);
+        EXPECT_NEAR(scaleAngle(toBinaryAngle(angle), angleScale, -32767, 32767), expected, 2) << "angle = " << angle;
+    }
+    // the angles beyond the maximum saturate
+    EXPECT_EQ(scaleAngle(toBinaryAngle(2.0F), angleScale, -32767, 32767), 32767);
+    EXPECT_EQ(scaleAngle(toBinaryAngle(-3.0F), angleScale, -32767, 32767), -32767);
+}
+
+/*
+the fixed-point fusion fed with raw samples follows the float complementary filter fed with the same samples in physical units
+*/
+TEST(FixedPointTest, FusionMatchesFloatPath)
+{
+    constexpr float AngularRateResolution = 0.00053264F;    // rad/s per LSB at 1000 deg/s full scale
+    constexpr float AccelerationResolution = 1.0F / 16384.0F;  // g per LSB
+    constexpr float SamplePeriod = 1.0F / 952.0F;
+    constexpr float TimeConstant = 0.42F;
+    FixedPointFusion<int16_t> fixedPointFusion(AngularRateResolution, SamplePeriod, TimeConstant);
+    ComplementaryFilter floatFusion(TimeConstant);
+    double maxError{0.0};
+    for(int sample = 0; sample < 20000; sample++)
+    {
+        double time = sample * SamplePeriod;
+        double pitch = 0.7 * std::sin(2.0 * time);
+        double roll = 0.5 * std::sin(3.0 * time);
+        float yawReference = static_cast<float>(0.8 * std::sin(0.5 * time));
+        Vector3D<int16_t> rawRate
+        {
+            static_cast<int16_t>(std::lround(1.5 * std::cos(3.0 * time) / AngularRateResolution)),
+            static_cast<int16_t>(std::lround(1.4 * std::cos(2.0 * time) / AngularRateResolution)),
+            static_cast<int16_t>(std::lround(0.4 * std::cos(0.5 * time) / AngularRateResolution))
+        };
+        Vector3D<int16_t> rawAcceleration
+        {
+            static_cast<int16_t>(std::lround(std::sin(roll) * std::cos(pitch) / AccelerationResolution)),
+            static_cast<int16_t>(std::lround(std::sin(pitch) / AccelerationResolution)),
+            static_cast<int16_t>(std::lround(std::cos(roll) * std::cos(pitch) / AccelerationResolution))
+        };
+        fixedPointFusion.setYawReference(toBinaryAngle(yawReference));
+        fixedPointFusion.update(rawRate, rawAcceleration);
+        floatFusion.setYawReference(yawReference);
+        floatFusion.update({rawRate.X * AngularRateResolution, rawRate.Y * AngularRateResolution, rawRate.Z * AngularRateResolution},
+                           {rawAcceleration.X * AccelerationResolution, rawAcceleration.Y * AccelerationResolution, rawAcceleration.Z * AccelerationResolution},
+                           SamplePeriod);
+        maxError = std::max(maxError, std::fabs(angleError(fixedPointFusion.getPitch(), floatFusion.getPitch())));
+        maxError = std::max(maxError, std::fabs(angleError(fixedPointFusion.getRoll(), floatFusion.getRoll())));
+        maxError = std::max(maxError, std::fabs(angleError(fixedPointFusion.getYaw(), floatFusion.getYaw())));
+    }
+    EXPECT_LT(maxError, 1e-4);
+}
@@ -0,0 +1,70 @@
+#include "HidDescriptor.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+    struct TestReport      //NOLINT(altera-struct-pack-align)
+    {
+        uint8_t reportId;
+        int16_t X;
+        int16_t Y;
+        uint8_t buttons;
+    } __attribute__((packed));
+
+    constexpr uint8_t GenericDesktopPage = 0x01U;
+    constexpr uint8_t ButtonPage = 0x09U;
+
+    constexpr HidReportFields<3> TestInputFields
+    {
+        1,
+        HidItem::Input,
+        {{
+            {GenericDesktopPage, 0x30, 1, 16, -32767, 32767, 0, 0, 0, HidVariable, false, offsetof(TestReport, X)},
+            {GenericDesktopPage, 0x31, 1, 16, -32767, 32767, 0, 0, 0, HidVariable, false, offsetof(TestReport, Y)},
+            {ButtonPage, 0x01, 8, 1, 0, 1, 0, 0, 0, HidVariable, false, offsetof(TestReport, buttons)}
+        }}
+    };
+
+    constexpr HidReportFields<1> TestFeatureFields
+    {
+        2,
+        HidItem::Feature,
+        {{
+            {0xFF00U, 0x01, 4, 8, 0, 255, 0, 0, 0, HidVariable, false, 1}
+        }}
+    };
+
+    constexpr size_t DescriptorLength = makeHidDescriptor<1>(GenericDesktopPage, 0x04, TestInputFields, TestFeatureFields).length;
+    constexpr auto Descriptor = makeHidDescriptor<DescriptorLength>(GenericDesktopPage, 0x04, TestInputFields, TestFeatureFields);
+} // namespace
+
+TEST(HidDescriptorTest, ReportSizeAndLayout)
+{
+    EXPECT_EQ(getHidReportSize(TestInputFields), sizeof(TestReport) * 8);
+    EXPECT_TRUE(isHidReportLayoutValid(TestInputFields));
+    EXPECT_EQ(getHidReportSize(TestFeatureFields), 5U * 8U);
+}
+
+TEST(HidDescriptorTest, GeneratesMergedItems)
+{
+    const std::vector<uint8_t> expected
+    {
+        0x05, 0x01, 0x09, 0x04, 0xA1, 0x01,         // usage page, usage, application collection
+        0x85, 0x01,                                 // report ID 1
+        0x16, 0x01, 0x80, 0x26, 0xFF, 0x7F,         // logical range -32767..32767
+        0x35, 0x00, 0x45, 0x00,                     // physical range 0..0
+        0x75, 0x10, 0x95, 0x02,                     // 2 fields of 16 bits
+        0x09, 0x30, 0x09, 0x31, 0x81, 0x02,         // X, Y input
+        0x05, 0x09, 0x15, 0x00, 0x25, 0x01,         // button page, logical range 0..1
+        0x75, 0x01, 0x95, 0x08,                     // 8 fields of 1 bit
+        0x19, 0x01, 0x29, 0x08, 0x81, 0x02,         // buttons 1..8 input
+        0x85, 0x02,                                 // report ID 2
+        0x06, 0x00, 0xFF, 0x26, 0xFF, 0x00,         // vendor page, logical maximum 255
+        0x75, 0x08, 0x95, 0x04,                     // 4 fields of 8 bits
+        0x19, 0x01, 0x29, 0x04, 0xB1, 0x02,         // usages 1..4 feature
+        0xC0                                        // end collection
+    };
+    ASSERT_EQ(Descriptor.length, expected.size());
+    EXPECT_EQ(std::vector<uint8_t>(Descriptor.data, Descriptor.data + Descriptor.length), expected);
+}
@@ -0,0 +1,100 @@
+#include "Orientation.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace
+{
+    constexpr float DeltaT = 0.001F;
+    constexpr float TimeConstant = 0.5F;
+    constexpr size_t SettlingSamples = 5000;   // 10 time constants
+
+    template<typename Engine> void feedSamples(Engine& engine, const Vector3D<float>& angularRate, const Vector3D<float>& acceleration, size_t samples)
+    {
+        for(size_t sample = 0; sample < samples; sample++)
+        {
+            engine.update(angularRate, acceleration, DeltaT);
+        }
+    }
+
+    template<typename Engine> class OrientationTest : public ::testing::Test
+    {
+    protected:
+        Engine engine{TimeConstant};
+    };
+
+    using Engines = ::testing::Types<ComplementaryFilter, MahonyFilter>;
+    TYPED_TEST_SUITE(OrientationTest, Engines);
+} // namespace
+
+TYPED_TEST(OrientationTest, ConvergesToStaticPitch)
+{
+    const float pitch = -0.5F;
+    feedSamples(this->engine, {0.0F, 0.0F, 0.0F}, {0.0F, std::sin(pitch), std::cos(pitch)}, SettlingSamples);
+    EXPECT_NEAR(this->engine.getPitch(), pitch, 1e-4F);
+    EXPECT_NEAR(this->engine.getRoll(), 0.0F, 1e-4F);
+}
+
+TYPED_TEST(OrientationTest, ConvergesToStaticRollAndYawReference)
+{
+    const float roll = 0.3F;
+    const float yaw = 0.4F;
+    this->engine.setYawReference(yaw);
+    feedSamples(this->engine, {0.0F, 0.0F, 0.0F}, {std::sin(roll), 0.0F, std::cos(roll)}, SettlingSamples);
+    EXPECT_NEAR(this->engine.getPitch(), 0.0F, 1e-4F);
+    EXPECT_NEAR(this->engine.getRoll(), roll, 1e-4F);
+    EXPECT_NEAR(this->engine.getYaw(), yaw, 1e-4F);
+    float sinYaw{0.0F};
+    float cosYaw{0.0F};
+    this->engine.getYawSinCos(sinYaw, cosYaw);
+    EXPECT_NEAR(sinYaw, std::sin(yaw), 1e-4F);
+    EXPECT_NEAR(cosYaw, std::cos(yaw), 1e-4F);
+}
+
+TYPED_TEST(OrientationTest, TracksPitchOscillation)
+{
+    const float amplitude = 0.6F;
+    const float omega = 6.2832F;     // 1 Hz
+    float maxError{0.0F};
+    for(size_t sample = 0; sample < 10000; sample++)
+    {
+        float time = static_cast<float>(sample) * DeltaT;
+        float pitch = amplitude * std::sin(omega * time);
+        this->engine.update({0.0F, amplitude * omega * std::cos(omega * time), 0.0F}, {0.0F, std::sin(pitch), std::cos(pitch)}, DeltaT);
+        maxError = std::max(maxError, std::fabs(this->engine.getPitch() - amplitude * std::sin(omega * (time + DeltaT))));
+    }
+    EXPECT_LT(maxError, 0.005F);
+}
+
+TYPED_TEST(OrientationTest, GyroscopeBiasErrorIsBiasTimesTimeConstant)
+{
+    const float bias = 0.02F;
+    feedSamples(this->engine, {bias, 0.0F, 0.0F}, {0.0F, 0.0F, 1.0F}, 4 * SettlingSamples);
+    EXPECT_NEAR(this->engine.getRoll(), bias * TimeConstant, 1e-4F);
+}
+
+TEST(MahonyFilterTest, IntegralGainRemovesGyroscopeBias)
+{
+    MahonyFilter engine(TimeConstant, 0.5F);
+    feedSamples(engine, {0.02F, 0.0F, 0.0F}, {0.0F, 0.0F, 1.0F}, 12 * SettlingSamples);
+    EXPECT_NEAR(engine.getRoll(), 0.0F, 1e-4F);
+}
+
+TEST(OrientationEnginesTest, EnginesAgreeInCombinedMotion)
+{
+    ComplementaryFilter complementaryFilter(TimeConstant);
+    MahonyFilter mahonyFilter(TimeConstant);
+    float maxDifference{0.0F};
+    for(size_t sample = 0; sample < 10000; sample++)
+    {
+        float time = static_cast<float>(sample) * DeltaT;
+        float pitch = 0.2F * std::sin(3.0F * time);
+        float roll = 0.2F * std::sin(2.0F * time);
+        Vector3D<float> angularRate{0.4F * std::cos(2.0F * time), 0.6F * std::cos(3.0F * time), 0.0F};
+        Vector3D<float> acceleration{std::sin(roll) * std::cos(pitch), std::sin(pitch), std::cos(roll) * std::cos(pitch)};
+        complementaryFilter.update(angularRate, acceleration, DeltaT);
+        mahonyFilter.update(angularRate, acceleration, DeltaT);
+        maxDifference = std::max(maxDifference, std::fabs(complementaryFilter.getPitch() - mahonyFilter.getPitch()));
+        maxDifference = std::max(maxDifference, std::fabs(complementaryFilter.getRoll() - mahonyFilter.getRoll()));
+    }
+    EXPECT_LT(maxDifference, 0.02F);
+}
@@ -0,0 +1,33 @@
+#include "SensorRecord.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(SensorRecordTest, Fletcher32MatchesReferenceValues)
+{
+    const std::array<uint8_t, 8> data{'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+    EXPECT_EQ(getFletcher32(data.data(), 3), 0x56502D2AU);
+    EXPECT_EQ(getFletcher32(data.data(), 4), 0xEBE19591U);
+}
+
+TEST(SensorRecordTest, Fletcher32OfLongDataIsReduced)
+{
+    // more than one block of 359 words with the maximum word values
+    std::vector<uint8_t> data(2000, 0xFF);
+    EXPECT_EQ(getFletcher32(data.data(), data.size() / 2), 0xFFFFFFFFU);
+}
+
+TEST(SensorRecordTest, TelemetryChecksumDetectsCorruptedPacket)
+{
+    TelemetryPacket packet{{'Y', 'T', 'L', 'M'}, sizeof(SensorRecord), 7, {}, 0};
+    packet.record.interruptTime = 123456;
+    packet.record.inputs.deltaT = 0.0084F;
+    packet.checksum = getTelemetryChecksum(packet);
+    EXPECT_EQ(packet.checksum, getTelemetryChecksum(packet));
+
+    TelemetryPacket corrupted = packet;
+    corrupted.sequence++;
+    EXPECT_NE(corrupted.checksum, getTelemetryChecksum(corrupted));
+    corrupted = packet;
+    corrupted.record.gyroAccelData[0] ^= 1U;
+    EXPECT_NE(corrupted.checksum, getTelemetryChecksum(corrupted));
+}
@@ -0,0 +1,205 @@
+/*
+host replay of the sensor recorder dumps and the telemetry streams
+reads the console capture of the 'rd' command or the serial capture of the 'rt' stream,
+finds the records and runs the recorded IMU frames through the orientation engines of the firmware;
+the result is written to stdout as CSV
+usage: yoke-replay <capture file>
+*/
+
+#include "FixedPoint.h"
+#include "Orientation.h"
+#include "SensorRecord.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // sensor settings of the yoke handler
+    constexpr float PI = 3.14159265359F;
+    constexpr float ImuSamplePeriod = 1.0F / 476.0F;
+    constexpr float AngularRateResolution = 500.0F * PI / 180.0F / 32768.0F;
+    constexpr float AccelerationResolution = 2.0F / 32768.0F;
+    constexpr float FusionTimeConstant = 0.42F;
+
+    /*
+    the orientation engines fed with the recorded frames in the same way as the yoke handler does
+    */
+    class ReplayPipeline
+    {
+    public:
+        void process(const SensorRecord& record, std::ostream& output)
+        {
+            // the handler keeps the orientation of the frames with failed transfers
+            if(record.isValid != 0)
+            {
+                update(record);
+            }
+            output << "," << complementaryFilter.getPitch() << "," << complementaryFilter.getRoll() << "," << complementaryFilter.getYaw()
+                   << "," << mahonyFilter.getPitch() << "," << mahonyFilter.getRoll() << "," << mahonyFilter.getYaw()
+                   << "," << binaryAngleToRadians(fixedPointFusion.getPitch()) << "," << binaryAngleToRadians(fixedPointFusion.getRoll())
+                   << "," << binaryAngleToRadians(fixedPointFusion.getYaw());
+        }
+    private:
+        void update(const SensorRecord& record)
+        {
+            if(record.isMagnetometerFresh != 0)
+            {
+                Vector3D<int16_t> magnetometerData{0, 0, 0};
+                parseMagnetometerSample(record.magnetometerData.data(), magnetometerData);
+                // yaw from magnetometer; atan2 +- PI is obtained by the binary angle wrap-around in the fixed-point path
+                float magnetometerYaw = -0.1F * PI * (fastAtan2(magnetometerData.Z, magnetometerData.X) + (magnetometerData.Z >= 0 ? -PI : PI));
+                complementaryFilter.setYawReference(magnetometerYaw);
+                mahonyFilter.setYawReference(magnetometerYaw);
+                int32_t fixedPointYaw = multiplyQ31(addAngles(fixedAtan2(magnetometerData.Z, magnetometerData.X), std::numeric_limits<int32_t>::min()), toQ31(-0.1F * PI));
+                fixedPointFusion.setYawReference(fixedPointYaw);
+            }
+            for(size_t sample = 0; sample < record.sampleCount; sample++)
+            {
+                Vector3D<int16_t> gyroscopeData{0, 0, 0};
+                Vector3D<int16_t> accelerometerData{0, 0, 0};
+                parseImuSample(&record.gyroAccelData[sample * ImuSampleDataSize], gyroscopeData, accelerometerData);
+                // body axes: X = roll axis, Y = pitch axis, Z = yaw axis
+                Vector3D<float> angularRate{-AngularRateResolution * gyroscopeData.Y, -AngularRateResolution * gyroscopeData.Z, AngularRateResolution * gyroscopeData.X};
+                Vector3D<float> acceleration{AccelerationResolution * accelerometerData.Z, -AccelerationResolution * accelerometerData.Y, -AccelerationResolution * accelerometerData.X};
+                complementaryFilter.update(angularRate, acceleration, ImuSamplePeriod);
+                mahonyFilter.update(angularRate, acceleration, ImuSamplePeriod);
+                fixedPointFusion.update({saturatedNegate(gyroscopeData.Y), saturatedNegate(gyroscopeData.Z), gyroscopeData.X},
+                                        {accelerometerData.Z, saturatedNegate(accelerometerData.Y), saturatedNegate(accelerometerData.X)});
+            }
+        }
+        ComplementaryFilter complementaryFilter{FusionTimeConstant};
+        MahonyFilter mahonyFilter{FusionTimeConstant};
+        FixedPointFusion<int16_t> fixedPointFusion{AngularRateResolution, ImuSamplePeriod, FusionTimeConstant};
+    };
+
+    /*
+    read the records of the sensor recorder dump, which follows the console text of the command
+    the time of the records is the interrupt time scaled with the core clock of the dump header
+    returns false if the capture contains no dump
+    */
+    bool readDump(const std::vector<char>& capture, std::vector<SensorRecord>& records, std::vector<double>& times)
+    {
+        const std::string tag{"YREC"};
+        size_t position = std::string(capture.begin(), capture.end()).find(tag);
+        RecorderDumpHeader header{};
+        if((position == std::string::npos) || (capture.size() < position + sizeof(header)))
+        {
+            return false;
+        }
+        std::memcpy(&header, &capture[position], sizeof(header));
+        position += sizeof(header);
+        if((header.version != RecorderDumpHeader::Version) || (header.recordSize != sizeof(SensorRecord)))
+        {
+            std::cerr << "unsupported dump version " << header.version << " with record size " << header.recordSize << std::endl;
+            return true;
+        }
+        size_t recordCount = std::min<size_t>(header.recordCount, (capture.size() - position) / sizeof(SensorRecord));
+        if(recordCount < header.recordCount)
+        {
+            std::cerr << "the dump is truncated to " << recordCount << " of " << header.recordCount << " records" << std::endl;
+        }
+        uint32_t startTime{0};
+        for(size_t index = 0; index < recordCount; index++)
+        {
+            SensorRecord record{};
+            std::memcpy(&record, &capture[position + index * sizeof(SensorRecord)], sizeof(SensorRecord));
+            if(index == 0)
+            {
+                startTime = record.interruptTime;
+            }
+            records.push_back(record);
+            // the interrupt time is the cycle counter value, which wraps around
+            times.push_back(static_cast<double>(record.interruptTime - startTime) / header.coreClock);
+        }
+        return true;
+    }
+
+    /*
+    read the records of the telemetry stream packets
+    a tag is accepted as a packet start only with the expected payload size and a valid checksum;
+    the stream carries no core clock, so the time of the records is the sum of the handler periods
+    */
+    void readStream(const std::vector<char>& capture, std::vector<SensorRecord>& records, std::vector<double>& times)
+    {
+        const std::string tag{"YTLM"};
+        const std::string text(capture.begin(), capture.end());
+        size_t position = text.find(tag);
+        size_t rejectedTags{0};
+        size_t lostPackets{0};
+        bool isFirstPacket{true};
+        uint16_t expectedSequence{0};
+        double time{0.0};
+        while((position != std::string::npos) && (position + sizeof(TelemetryPacket) <= capture.size()))
+        {
+            TelemetryPacket packet{};
+            std::memcpy(&packet, &capture[position], sizeof(packet));
+            if((packet.payloadSize != sizeof(SensorRecord)) || (packet.checksum != getTelemetryChecksum(packet)))
+            {
+                rejectedTags++;
+                position = text.find(tag, position + 1);
+                continue;
+            }
+            if(!isFirstPacket)
+            {
+                lostPackets += static_cast<uint16_t>(packet.sequence - expectedSequence);
+                time += packet.record.inputs.deltaT;
+            }
+            isFirstPacket = false;
+            expectedSequence = packet.sequence + 1;
+            records.push_back(packet.record);
+            times.push_back(time);
+            position = text.find(tag, position + sizeof(packet));
+        }
+        if((rejectedTags != 0) || (lostPackets != 0))
+        {
+            std::cerr << "telemetry stream: rejected tags = " << rejectedTags << ", lost packets = " << lostPackets << std::endl;
+        }
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2)
+    {
+        std::cerr << "usage: yoke-replay <capture file>" << std::endl;
+        return 1;
+    }
+    std::ifstream file(argv[1], std::ios::binary);
+    if(!file)
+    {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    const std::vector<char> capture((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::vector<SensorRecord> records;
+    std::vector<double> times;
+    if(!readDump(capture, records, times))
+    {
+        readStream(capture, records, times);
+    }
+    if(records.empty())
+    {
+        std::cerr << "no sensor records found" << std::endl;
+        return 1;
+    }
+
+    std::cout << "record,time,deltaT,samples,valid,throttle,propeller,mixture,switches,hat,"
+                 "complementaryPitch,complementaryRoll,complementaryYaw,mahonyPitch,mahonyRoll,mahonyYaw,fixedPointPitch,fixedPointRoll,fixedPointYaw" << std::endl;
+    ReplayPipeline pipeline;
+    for(size_t index = 0; index < records.size(); index++)
+    {
+        const SensorRecord& record = records[index];
+        std::cout << index << "," << times[index] << "," << record.inputs.deltaT << "," << static_cast<int>(record.sampleCount) << "," << static_cast<int>(record.isValid)
+                  << "," << record.inputs.potentiometers[0] << "," << record.inputs.potentiometers[1] << "," << record.inputs.potentiometers[2]
+                  << "," << record.inputs.switches << "," << static_cast<int>(record.inputs.hatPosition);
+        pipeline.process(record, std::cout);
+        std::cout << std::endl;
+    }
+    return 0;
+}
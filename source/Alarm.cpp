@@ -79,7 +79,9 @@ void Alarm::displayOnScreen() const
         "W",    // I2C write
         "Wr",   // I2C write before read
         "wR",   // read after write
-        "I"     // no gyroscope interrupt
+        "I",    // no gyroscope interrupt
+        "A",    // ADC acquisition start
+        "T"     // failed or aborted IMU transfer
     };
     constexpr uint8_t LimitX = 127U;
     Display::getInstance().setFont(static_cast<const uint8_t*>(FontTahoma11), false, LimitX);
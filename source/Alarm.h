@@ -16,7 +16,9 @@ enum class AlarmID
     I2CWrite,
     I2CWriteBeforeRead,
     I2CReadAfterWrite,
-    NoImuInterrupt
+    NoImuInterrupt,
+    AdcStart,
+    ImuTransfer         // failed or aborted asynchronous IMU transfer
 };
 
 class Alarm
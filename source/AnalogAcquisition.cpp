@@ -0,0 +1,116 @@
+#include "AnalogAcquisition.h"
+#include "Alarm.h"
+
+#if ANALOG_ACQUISITION_DMA
+constexpr uint32_t AdcFullScale = 4095U;        // 12-bit conversion
+// circular DMA buffer of the consecutive scans; aligned to the cache line for the cache maintenance on STM32F7
+MBED_ALIGN(32) static std::array<uint16_t, AnalogAcquisition::NumberOfChannels * AnalogAcquisition::NumberOfScans> adcBuffer;     //NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
+AnalogAcquisition::AnalogAcquisition(const std::array<PinName, NumberOfChannels>& pins) :
+    pins(pins)
+{
+}
+
+/*
+start the acquisition of all channels
+*/
+void AnalogAcquisition::start()
+{
+#if ANALOG_ACQUISITION_DMA
+    // ADC channel numbers in the pin map are the channel indexes of the STM32 HAL
+    const std::array<uint32_t, 19> adcChannels     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    {
+        ADC_CHANNEL_0, ADC_CHANNEL_1, ADC_CHANNEL_2, ADC_CHANNEL_3, ADC_CHANNEL_4, ADC_CHANNEL_5, ADC_CHANNEL_6,
+        ADC_CHANNEL_7, ADC_CHANNEL_8, ADC_CHANNEL_9, ADC_CHANNEL_10, ADC_CHANNEL_11, ADC_CHANNEL_12, ADC_CHANNEL_13,
+        ADC_CHANNEL_14, ADC_CHANNEL_15, ADC_CHANNEL_16, ADC_CHANNEL_17, ADC_CHANNEL_18
+    };
+
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    // ADC1 scans all channels continuously; every conversion is a DMA request
+    adcHandle.Instance = ADC1;
+    adcHandle.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
+    adcHandle.Init.Resolution = ADC_RESOLUTION_12B;
+    adcHandle.Init.ScanConvMode = ENABLE;
+    adcHandle.Init.ContinuousConvMode = ENABLE;
+    adcHandle.Init.DiscontinuousConvMode = DISABLE;
+    adcHandle.Init.NbrOfDiscConversion = 0;
+    adcHandle.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
+    adcHandle.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+    adcHandle.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+    adcHandle.Init.NbrOfConversion = NumberOfChannels;
+    adcHandle.Init.DMAContinuousRequests = ENABLE;
+    adcHandle.Init.EOCSelection = ADC_EOC_SEQ_CONV;
+    bool isError = HAL_ADC_Init(&adcHandle) != HAL_OK;
+
+    // the longest sampling time: one scan takes about 130 us, so the buffer holds about 2 ms of samples
+    for(size_t index = 0; index < NumberOfChannels; index++)
+    {
+        uint32_t function = pinmap_function(pins[index], PinMap_ADC);
+        pin_function(pins[index], function);
+        ADC_ChannelConfTypeDef channelConfig{};
+        channelConfig.Channel = adcChannels[STM_PIN_CHANNEL(function)];
+        channelConfig.Rank = index + 1;
+        channelConfig.SamplingTime = ADC_SAMPLETIME_480CYCLES;
+        isError = isError || (HAL_ADC_ConfigChannel(&adcHandle, &channelConfig) != HAL_OK);
+    }
+
+    // ADC1 is served by DMA2 Stream0 Channel0; no DMA interrupts are enabled
+    dmaHandle.Instance = DMA2_Stream0;
+    dmaHandle.Init.Channel = DMA_CHANNEL_0;
+    dmaHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    dmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
+    dmaHandle.Init.MemInc = DMA_MINC_ENABLE;
+    dmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    dmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    dmaHandle.Init.Mode = DMA_CIRCULAR;
+    dmaHandle.Init.Priority = DMA_PRIORITY_LOW;
+    dmaHandle.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    isError = isError || (HAL_DMA_Init(&dmaHandle) != HAL_OK);
+    __HAL_LINKDMA(&adcHandle, DMA_Handle, dmaHandle);
+
+    isError = isError || (HAL_ADC_Start_DMA(&adcHandle, reinterpret_cast<uint32_t*>(adcBuffer.data()), adcBuffer.size()) != HAL_OK);
+    if(isError)
+    {
+        Alarm::getInstance().set(AlarmID::AdcStart);
+    }
+#else
+    for(size_t index = 0; index < NumberOfChannels; index++)
+    {
+        analogin_init(&inputs[index], pins[index]);
+    }
+#endif
+}
+
+/*
+get the values of all channels in the range <0,1>
+*/
+void AnalogAcquisition::read(std::array<float, NumberOfChannels>& values)
+{
+#if ANALOG_ACQUISITION_DMA
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    // the buffer is written by DMA behind the data cache
+    SCB_InvalidateDCache_by_Addr(reinterpret_cast<uint32_t*>(adcBuffer.data()), sizeof(adcBuffer));
+#endif
+    std::array<uint32_t, NumberOfChannels> sums{};
+    for(size_t scan = 0; scan < NumberOfScans; scan++)
+    {
+        for(size_t channel = 0; channel < NumberOfChannels; channel++)
+        {
+            sums[channel] += adcBuffer[scan * NumberOfChannels + channel];
+        }
+    }
+    constexpr float Scale = 1.0F / static_cast<float>(AdcFullScale * NumberOfScans);
+    for(size_t channel = 0; channel < NumberOfChannels; channel++)
+    {
+        values[channel] = static_cast<float>(sums[channel]) * Scale;
+    }
+#else
+    for(size_t channel = 0; channel < NumberOfChannels; channel++)
+    {
+        values[channel] = analogin_read(&inputs[channel]);
+    }
+#endif
+}
@@ -0,0 +1,39 @@
+#ifndef ANALOGACQUISITION_H_
+#define ANALOGACQUISITION_H_
+
+#include <mbed.h>
+#include <array>
+
+#if defined(TARGET_STM32F4) || defined(TARGET_STM32F7)
+#define ANALOG_ACQUISITION_DMA  1
+#else
+#define ANALOG_ACQUISITION_DMA  0
+#endif
+
+/*
+Acquisition of the analog inputs in the background
+on STM32F4/F7 the ADC1 scans all channels continuously and DMA2 Stream0 stores the conversions in a circular buffer
+of NumberOfScans scans; read() averages all scans of the buffer, so no conversion is started on the handler path
+and the accumulated 16 scans add 2 bits of effective resolution to the 12-bit samples
+these families have no hardware oversampling, so the accumulation is done on read
+on other targets the inputs are read with single conversions
+*/
+class AnalogAcquisition
+{
+public:
+    static constexpr size_t NumberOfChannels = 6;
+    static constexpr size_t NumberOfScans = 16;
+    explicit AnalogAcquisition(const std::array<PinName, NumberOfChannels>& pins);
+    void start();
+    void read(std::array<float, NumberOfChannels>& values);
+private:
+    std::array<PinName, NumberOfChannels> pins;
+#if ANALOG_ACQUISITION_DMA
+    ADC_HandleTypeDef adcHandle{};
+    DMA_HandleTypeDef dmaHandle{};
+#else
+    std::array<analogin_t, NumberOfChannels> inputs{};
+#endif
+};
+
+#endif /* ANALOGACQUISITION_H_ */
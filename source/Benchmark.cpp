@@ -0,0 +1,252 @@
+#include "Benchmark.h"
+#include "Filter.h"
+#include "FixedPoint.h"
+#include "Orientation.h"
+#include "SortedMedian.h"
+#include "Statistics.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr size_t NumberOfSamples = 16;      // number of prepared input samples
+    constexpr uint32_t NumberOfRuns = 1000;     // number of measured function calls
+    constexpr float SamplePeriod = 1.0F / 476.0F;
+    constexpr float AngularRateResolution = 500.0F * 3.14159265359F / 180.0F / 32768.0F;     // [rad/s per LSB]
+    constexpr float AccelerationResolution = 2.0F / 32768.0F;     // [g per LSB]
+
+    struct ImuSample        //NOLINT(altera-struct-pack-align)
+    {
+        Vector3D<float> angularRate;
+        Vector3D<float> acceleration;
+    };
+
+    /*
+    prepare IMU samples of a yoke swinging in pitch and roll
+    */
+    std::array<ImuSample, NumberOfSamples> prepareImuSamples()
+    {
+        constexpr float Amplitude = 0.5F;       // [rad]
+        constexpr float TwoPI = 6.2831853F;
+        std::array<ImuSample, NumberOfSamples> samples{};
+        for(size_t index = 0; index < NumberOfSamples; index++)
+        {
+            float phase = TwoPI * static_cast<float>(index) / static_cast<float>(NumberOfSamples);
+            float pitch = Amplitude * sin(phase);
+            float roll = Amplitude * cos(phase);
+            samples[index].angularRate = {Amplitude * cos(phase), -Amplitude * sin(phase), 0.0F};
+            samples[index].acceleration = {cos(pitch) * sin(roll), sin(pitch), cos(pitch) * cos(roll)};
+        }
+        return samples;
+    }
+
+    /*
+    measure orientation filter update and readout cost
+    */
+    template<typename Filter> void benchmarkOrientationFilter(const char* name, Filter& filter, const std::array<ImuSample, NumberOfSamples>& samples)
+    {
+        float sinYaw{0.0F};
+        float cosYaw{0.0F};
+        float result{0.0F};
+
+        uint32_t startTime = getCycleCount();
+        for(uint32_t run = 0; run < NumberOfRuns; run++)
+        {
+            const ImuSample& sample = samples[run % NumberOfSamples];
+            filter.update(sample.angularRate, sample.acceleration, SamplePeriod);
+        }
+        uint32_t updateCycles = getCycleCount() - startTime;
+
+        startTime = getCycleCount();
+        for(uint32_t run = 0; run < NumberOfRuns; run++)
+        {
+            filter.setYawReference(static_cast<float>(run % NumberOfSamples) * SamplePeriod);
+            filter.getYawSinCos(sinYaw, cosYaw);
+            result += filter.getPitch() + filter.getRoll() + filter.getYaw() + sinYaw + cosYaw;
+        }
+        uint32_t readoutCycles = getCycleCount() - startTime;
+
+        std::cout << name << ": update = " << updateCycles / NumberOfRuns << " cycles, ";
+        std::cout << "yaw reference and readout = " << readoutCycles / NumberOfRuns << " cycles";
+        std::cout << " (" << result << ")" << std::endl;
+    }
+
+    /*
+    convert prepared IMU sample to raw sensor values
+    */
+    void toRawSample(const ImuSample& sample, Vector3D<int16_t>& angularRate, Vector3D<int16_t>& acceleration)
+    {
+        auto toRaw = [](float value, float resolution) { return static_cast<int16_t>(lroundf(value / resolution)); };
+        angularRate = {toRaw(sample.angularRate.X, AngularRateResolution), toRaw(sample.angularRate.Y, AngularRateResolution), toRaw(sample.angularRate.Z, AngularRateResolution)};
+        acceleration = {toRaw(sample.acceleration.X, AccelerationResolution), toRaw(sample.acceleration.Y, AccelerationResolution), toRaw(sample.acceleration.Z, AccelerationResolution)};
+    }
+
+    /*
+    pseudo-random potentiometer readings with spikes
+    */
+    float potentiometerSample(uint32_t run)
+    {
+        constexpr uint32_t Multiplier = 1664525U;
+        constexpr uint32_t Increment = 1013904223U;
+        constexpr float Scale = 1.0F / 4294967296.0F;
+        constexpr uint32_t SpikePeriod = 23;
+        uint32_t random = run * Multiplier + Increment;
+        float noise = static_cast<float>(random) * Scale * 0.01F;     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        return ((run % SpikePeriod) == 0) ? 1.0F : 0.5F + noise;     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }
+
+    /*
+    measure the cost of the filter calculation and readout
+    */
+    template<typename Filter> uint32_t measureFilter(Filter& filter, float& result)
+    {
+        uint32_t startTime = getCycleCount();
+        for(uint32_t run = 0; run < NumberOfRuns; run++)
+        {
+            filter.calculate(potentiometerSample(run));
+            result += filter.getValue();
+        }
+        return (getCycleCount() - startTime) / NumberOfRuns;
+    }
+
+    /*
+    display the throughput of the scalar and block calculation of the same samples
+    */
+    void displayThroughput(const char* name, uint32_t scalarCycles, uint32_t blockCycles, uint32_t numberOfSamples)
+    {
+        auto samplesPerSecond = [numberOfSamples](uint32_t cycles)
+        {
+            return static_cast<uint32_t>(static_cast<uint64_t>(SystemCoreClock) * numberOfSamples / std::max<uint32_t>(cycles, 1));
+        };
+        std::cout << name << ": scalar = " << samplesPerSecond(scalarCycles) << " samples/s";
+        std::cout << ", block = " << samplesPerSecond(blockCycles) << " samples/s" << std::endl;
+    }
+} // namespace
+
+/*
+compare the costs of the orientation filters
+*/
+void benchmarkOrientation(CommandVector&  /*cv*/)
+{
+    auto samples = prepareImuSamples();
+    constexpr float TimeConstant = 0.42F;
+    ComplementaryFilter complementaryFilter(TimeConstant);
+    MahonyFilter mahonyFilter(TimeConstant);
+    benchmarkOrientationFilter("complementary filter", complementaryFilter, samples);
+    benchmarkOrientationFilter("Mahony filter", mahonyFilter, samples);
+}
+
+/*
+compare the fixed-point fusion with the floating-point complementary filter
+both filters are fed with the same raw sensor samples; the agreement of the angles is verified by the host tests
+*/
+void benchmarkFixedPoint(CommandVector&  /*cv*/)
+{
+    auto samples = prepareImuSamples();
+    constexpr float TimeConstant = 0.42F;
+    constexpr float YawReference = 0.2F;    // [rad]
+    ComplementaryFilter floatFilter(TimeConstant);
+    FixedPointFusion<int16_t> fixedPointFusion(AngularRateResolution, SamplePeriod, TimeConstant);
+    floatFilter.setYawReference(YawReference);
+    fixedPointFusion.setYawReference(toBinaryAngle(YawReference));
+
+    Vector3D<int16_t> angularRate{0, 0, 0};
+    Vector3D<int16_t> acceleration{0, 0, 0};
+    uint32_t floatCycles{0};
+    uint32_t fixedPointCycles{0};
+    for(uint32_t run = 0; run < NumberOfRuns; run++)
+    {
+        toRawSample(samples[run % NumberOfSamples], angularRate, acceleration);
+        // the floating-point path includes the conversion of the raw values, as in the yoke handler
+        uint32_t startTime = getCycleCount();
+        Vector3D<float> floatAngularRate{AngularRateResolution * angularRate.X, AngularRateResolution * angularRate.Y, AngularRateResolution * angularRate.Z};
+        Vector3D<float> floatAcceleration{AccelerationResolution * acceleration.X, AccelerationResolution * acceleration.Y, AccelerationResolution * acceleration.Z};
+        floatFilter.update(floatAngularRate, floatAcceleration, SamplePeriod);
+        floatCycles += getCycleCount() - startTime;
+
+        startTime = getCycleCount();
+        fixedPointFusion.update(angularRate, acceleration);
+        fixedPointCycles += getCycleCount() - startTime;
+    }
+
+    std::cout << "floating-point update = " << floatCycles / NumberOfRuns << " cycles" << std::endl;
+    std::cout << "fixed-point update = " << fixedPointCycles / NumberOfRuns << " cycles";
+    std::cout << " (" << floatFilter.getPitch() + binaryAngleToRadians(fixedPointFusion.getPitch()) << ")" << std::endl;
+}
+
+/*
+compare the cycles of the heap-based moving median and the sorted vector reference at several window sizes
+the medians are verified against a sorted window by the host tests
+the compile-time sized filters are compared with the run-time sized filters of the same window,
+the throughput of the 16-bit block calculation, which uses the DSP instructions of the target, is compared
+with the samples calculated one by one, and the cycles of the 4th order biquad low-pass are measured
+*/
+void benchmarkFilters(CommandVector&  /*cv*/)
+{
+    constexpr std::array<size_t, 6> WindowSizes{5, 15, 31, 63, 127, 255};      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    for(auto windowSize : WindowSizes)
+    {
+        FilterMM heapMedian(windowSize);
+        SortedMedian sortedMedian(windowSize);
+        float result{0.0F};
+        std::cout << "median of " << windowSize << ": heap = " << measureFilter(heapMedian, result) << " cycles";
+        std::cout << ", sorted vector = " << measureFilter(sortedMedian, result) << " cycles";
+        std::cout << " (" << result << ")" << std::endl;
+    }
+
+    constexpr size_t AverageSize = 16;
+    constexpr size_t MedianSize = 15;
+    float result{0.0F};
+    FilterMovingAverage<float, AverageSize> fixedAverage;
+    FilterSMA dynamicAverage(AverageSize);
+    FilterMovingMedian<float, MedianSize> fixedMedian;
+    FilterMM dynamicMedian(MedianSize);
+    std::cout << "average of " << AverageSize << ": compile-time size = " << measureFilter(fixedAverage, result) << " cycles";
+    std::cout << ", run-time size = " << measureFilter(dynamicAverage, result) << " cycles" << std::endl;
+    std::cout << "median of " << MedianSize << ": compile-time size = " << measureFilter(fixedMedian, result) << " cycles";
+    std::cout << ", run-time size = " << measureFilter(dynamicMedian, result) << " cycles" << std::endl;
+
+    // block calculation of the 16-bit samples; the block path sums the sample pairs with the dual multiply-accumulate instruction,
+    // which the host build replaces with the plain loop
+    constexpr size_t BlockSize = AverageSize / 2;       // a block shorter than the window, as in a FIFO drain
+    constexpr uint32_t NumberOfBlocks = NumberOfRuns / BlockSize;
+    std::array<int16_t, BlockSize> integerBlock{};
+    for(size_t index = 0; index < BlockSize; index++)
+    {
+        integerBlock[index] = static_cast<int16_t>(potentiometerSample(index) * 4095.0F);      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }
+    FilterMovingAverage<int16_t, AverageSize> scalarSma;
+    FilterMovingAverage<int16_t, AverageSize> blockSma;
+    uint32_t startTime = getCycleCount();
+    for(uint32_t block = 0; block < NumberOfBlocks; block++)
+    {
+        for(auto sample : integerBlock)
+        {
+            scalarSma.calculate(sample);
+        }
+    }
+    uint32_t scalarCycles = getCycleCount() - startTime;
+    startTime = getCycleCount();
+    for(uint32_t block = 0; block < NumberOfBlocks; block++)
+    {
+        blockSma.calculate(mbed::Span<const int16_t>(integerBlock.data(), BlockSize));
+    }
+    displayThroughput("int16 SMA", scalarCycles, getCycleCount() - startTime, NumberOfBlocks * BlockSize);
+    result += static_cast<float>(scalarSma.getValue() - blockSma.getValue());
+
+    // the 4th order low-pass of the throttle at the yoke handler rate; its responses are verified by the host tests
+    constexpr float SampleRate = 119.0F;    // [Hz]
+    constexpr float CutoffFrequency = 5.0F;     // [Hz]
+    FilterBiquad<2> lowPass;
+    lowPass.designLowPass(CutoffFrequency, SampleRate);
+    startTime = getCycleCount();
+    for(uint32_t run = 0; run < NumberOfRuns; run++)
+    {
+        lowPass.calculate(potentiometerSample(run));
+    }
+    std::cout << "4th order low-pass = " << (getCycleCount() - startTime) / NumberOfRuns << " cycles";
+    std::cout << " (" << result + lowPass.getValue() << ")" << std::endl;
+}
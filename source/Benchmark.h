@@ -0,0 +1,14 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include "Console.h"
+
+/*
+on-target benchmarks of the hot path algorithms
+the results are given in CPU clock cycles measured with the DWT cycle counter
+*/
+void benchmarkOrientation(CommandVector& cv);
+void benchmarkFixedPoint(CommandVector& cv);
+void benchmarkFilters(CommandVector& cv);
+
+#endif /* BENCHMARK_H_ */
@@ -0,0 +1,72 @@
+#ifndef BUTTONMAP_H_
+#define BUTTONMAP_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// mapping of an input bit to a joystick button bit
+struct ButtonMapping
+{
+    uint8_t input;          // bit of the input word
+    uint8_t button;         // bit of the joystick buttons word
+    bool isActiveLow;       // the button is pressed at input level 0
+};
+
+/*
+Compile-time button mapping table
+the mappings with the same distance between the input bit and the button bit are merged into one mask,
+so the buttons word is built with one mask and shift operation per distinct distance
+*/
+template<size_t NumberOfMappings> struct ButtonMapTable
+{
+    struct ShiftGroup
+    {
+        uint32_t inputMask;     // input bits of this group
+        int shift;              // button bit minus input bit
+    };
+    ShiftGroup groups[NumberOfMappings];    //NOLINT(hicpp-avoid-c-arrays,modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+    size_t numberOfGroups;
+    uint32_t activeLowMask;     // input bits of the active low buttons
+
+    // returns the buttons word of the input word
+    uint32_t map(uint32_t inputs) const
+    {
+        uint32_t active = inputs ^ activeLowMask;
+        uint32_t buttons = 0;
+        for(size_t index = 0; index < numberOfGroups; index++)
+        {
+            uint32_t bits = active & groups[index].inputMask;
+            buttons |= (groups[index].shift >= 0) ? (bits << groups[index].shift) : (bits >> -groups[index].shift);
+        }
+        return buttons;
+    }
+};
+
+template<size_t NumberOfMappings> constexpr ButtonMapTable<NumberOfMappings> makeButtonMapTable(const std::array<ButtonMapping, NumberOfMappings>& mappings)
+{
+    ButtonMapTable<NumberOfMappings> table{};
+    for(size_t mappingIndex = 0; mappingIndex < NumberOfMappings; mappingIndex++)
+    {
+        const ButtonMapping& mapping = mappings[mappingIndex];
+        int shift = static_cast<int>(mapping.button) - static_cast<int>(mapping.input);
+        size_t groupIndex = 0;
+        while((groupIndex < table.numberOfGroups) && (table.groups[groupIndex].shift != shift))
+        {
+            groupIndex++;
+        }
+        if(groupIndex == table.numberOfGroups)
+        {
+            table.groups[groupIndex].shift = shift;
+            table.numberOfGroups++;
+        }
+        table.groups[groupIndex].inputMask |= 1U << mapping.input;
+        if(mapping.isActiveLow)
+        {
+            table.activeLowMask |= 1U << mapping.input;
+        }
+    }
+    return table;
+}
+
+#endif /* BUTTONMAP_H_ */
@@ -0,0 +1,172 @@
+#include "CdcStream.h"
+#include <algorithm>
+#include <cstring>
+
+#if MBED_CONF_APP_USB_CONSOLE
+namespace mbed
+{
+    // stdio console is the USB CDC-ACM interface
+    FileHandle* mbed_override_console(int /*fd*/)
+    {
+        return &CdcStream::getInstance();
+    }
+} // namespace mbed
+#endif
+
+CdcStream& CdcStream::getInstance()
+{
+    static CdcStream instance;  // Guaranteed to be destroyed, instantiated on first use
+    return instance;
+}
+
+/*
+read the received data; waits until at least one byte is received
+*/
+ssize_t CdcStream::read(void* buffer, size_t size)
+{
+    auto* data = static_cast<uint8_t*>(buffer);
+    while(size != 0)
+    {
+        {
+            CriticalSectionLock lock;
+            size_t count = std::min(size, receiveCount);
+            for(size_t index = 0; index < count; index++)
+            {
+                data[index] = receiveBuffer[(receiveHead + index) % ReceiveBufferSize];
+            }
+            receiveHead = (receiveHead + count) % ReceiveBufferSize;
+            receiveCount -= count;
+            if(count != 0)
+            {
+                return static_cast<ssize_t>(count);
+            }
+        }
+        eventFlags.wait_any(ReceiveFlag);
+    }
+    return 0;
+}
+
+/*
+write the data to the transmit buffer
+while the host has the port open, waits for the USB transfers to free the buffer space;
+otherwise the data exceeding the free space is dropped
+*/
+ssize_t CdcStream::write(const void* buffer, size_t size)
+{
+    if(isTextSuppressed)
+    {
+        // the binary stream must not be interleaved with text
+        return static_cast<ssize_t>(size);
+    }
+    constexpr Kernel::Clock::duration_u32 TransmitTimeout{100ms};
+    const auto* data = static_cast<const uint8_t*>(buffer);
+    size_t written = storeTransmitData(data, size);
+    while(written < size)
+    {
+        if(!isConnected || core_util_is_isr_active() ||
+           ((eventFlags.wait_any_for(TransmitFlag, TransmitTimeout) & osFlagsError) != 0))
+        {
+            core_util_atomic_incr_u32(&bytesDropped, size - written);
+            break;
+        }
+        written += storeTransmitData(data + written, size - written);
+    }
+    // the dropped data is reported as written, so the stdio does not retry it
+    return static_cast<ssize_t>(size);
+}
+
+/*
+write the data to the transmit buffer without waiting
+the data is written as a whole or dropped, so the packets in the stream are never truncated
+returns true if the data has been written
+*/
+bool CdcStream::writeNonBlocking(const void* buffer, size_t size)
+{
+    if(storeTransmitData(static_cast<const uint8_t*>(buffer), size, true) == 0)
+    {
+        core_util_atomic_incr_u32(&bytesDropped, size);
+        return false;
+    }
+    return true;
+}
+
+short CdcStream::poll(short events) const
+{
+    CriticalSectionLock lock;
+    short revents = 0;
+    if(receiveCount != 0)
+    {
+        revents |= POLLIN;
+    }
+    if(transmitCount < TransmitBufferSize)
+    {
+        revents |= POLLOUT;
+    }
+    return static_cast<short>(revents & events);
+}
+
+/*
+store as much of the data as fits in the transmit buffer and notify the USB device
+with isWholeOnly set, nothing is stored if the data does not fit
+*/
+size_t CdcStream::storeTransmitData(const uint8_t* data, size_t size, bool isWholeOnly)
+{
+    size_t count = 0;
+    {
+        CriticalSectionLock lock;
+        count = std::min(size, TransmitBufferSize - transmitCount);
+        if(isWholeOnly && (count < size))
+        {
+            count = 0;
+        }
+        size_t tail = (transmitHead + transmitCount) % TransmitBufferSize;
+        size_t firstPart = std::min(count, TransmitBufferSize - tail);
+        memcpy(&transmitBuffer[tail], data, firstPart);
+        memcpy(transmitBuffer.data(), data + firstPart, count - firstPart);
+        transmitCount += count;
+    }
+    if((count != 0) && transmitCb)
+    {
+        transmitCb();
+    }
+    return count;
+}
+
+/*
+take the data of the next USB transfer from the transmit buffer (USB interrupt context)
+*/
+size_t CdcStream::takeTransmitData(uint8_t* buffer, size_t maxSize)
+{
+    CriticalSectionLock lock;
+    size_t count = std::min(maxSize, transmitCount);
+    size_t firstPart = std::min(count, TransmitBufferSize - transmitHead);
+    memcpy(buffer, &transmitBuffer[transmitHead], firstPart);
+    memcpy(buffer + firstPart, transmitBuffer.data(), count - firstPart);
+    transmitHead = (transmitHead + count) % TransmitBufferSize;
+    transmitCount -= count;
+    if(count != 0)
+    {
+        eventFlags.set(TransmitFlag);
+    }
+    return count;
+}
+
+/*
+store the data of a USB transfer in the receive buffer (USB interrupt context)
+the data exceeding the free space is dropped
+*/
+void CdcStream::storeReceivedData(const uint8_t* data, size_t size)
+{
+    CriticalSectionLock lock;
+    size_t count = std::min(size, ReceiveBufferSize - receiveCount);
+    for(size_t index = 0; index < count; index++)
+    {
+        receiveBuffer[(receiveHead + receiveCount + index) % ReceiveBufferSize] = data[index];
+    }
+    receiveCount += count;
+    bytesDropped += size - count;
+    if(count != 0)
+    {
+        eventFlags.set(ReceiveFlag);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef CDCSTREAM_H_
+#define CDCSTREAM_H_
+
+#include <mbed.h>
+#include <array>
+
+/*
+Byte stream of the USB CDC-ACM interface
+the stream is the stdio console when the usb-console parameter is set, so the Console and Logger text goes to the USB host;
+the written data is buffered until the USB device takes it for the bulk IN transfers, and the data received
+from the bulk OUT transfers is buffered until it is read
+the stream exists before the USB device is started, so the early log messages are kept in the transmit buffer
+while the text is suppressed, write() discards the data, so only the binary packets of writeNonBlocking() are sent
+*/
+class CdcStream : public FileHandle
+{
+public:
+    static CdcStream& getInstance();
+    CdcStream(CdcStream const&) = delete;
+    void operator=(CdcStream const&) = delete;
+    CdcStream(CdcStream&&) = delete;
+    void operator=(CdcStream&&) = delete;
+    ssize_t read(void* buffer, size_t size) override;
+    ssize_t write(const void* buffer, size_t size) override;
+    bool writeNonBlocking(const void* buffer, size_t size);
+    off_t seek(off_t /*offset*/, int /*whence*/) override { return -ESPIPE; }
+    int close() override { return 0; }
+    short poll(short events) const override;
+    int isatty() override { return 1; }     // line buffered stdio as on the serial console
+    void setTextSuppressed(bool suppressed) { isTextSuppressed = suppressed; }
+    // USB device interface, called in the USB interrupt context
+    void setTransmitCallback(Callback<void()> cb) { transmitCb = cb; }
+    size_t takeTransmitData(uint8_t* buffer, size_t maxSize);
+    void storeReceivedData(const uint8_t* data, size_t size);
+    void setConnected(bool connected) { isConnected = connected; }
+    uint32_t getBytesDropped() const { return bytesDropped; }
+private:
+    CdcStream() = default;
+    ~CdcStream() override = default;
+    size_t storeTransmitData(const uint8_t* data, size_t size, bool isWholeOnly = false);
+    static constexpr size_t TransmitBufferSize = 4096;
+    static constexpr size_t ReceiveBufferSize = 256;
+    static constexpr uint32_t ReceiveFlag = 0x01U;      // data has been received
+    static constexpr uint32_t TransmitFlag = 0x02U;     // the USB device has taken data from the transmit buffer
+    std::array<uint8_t, TransmitBufferSize> transmitBuffer{};
+    size_t transmitHead{0};                 // index of the oldest byte in the transmit buffer
+    size_t transmitCount{0};                // number of bytes in the transmit buffer
+    std::array<uint8_t, ReceiveBufferSize> receiveBuffer{};
+    size_t receiveHead{0};                  // index of the oldest byte in the receive buffer
+    size_t receiveCount{0};                 // number of bytes in the receive buffer
+    EventFlags eventFlags;
+    Callback<void()> transmitCb{nullptr};   // starts the USB transfer of the buffered data
+    volatile bool isConnected{false};       // the host has opened the port (DTR set)
+    volatile bool isTextSuppressed{false};  // the console and log text is discarded during the binary streaming
+    uint32_t bytesDropped{0};               // bytes not written or received, because the buffer was full
+};
+
+#endif /* CDCSTREAM_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include "Convert.h"
+#include <array>
 #include <cmath>
 
 float cropAngle(float angle)
@@ -65,4 +66,128 @@ float fastAtan(float tan)
     }
 
     return sgn * atan;
-}
\ No newline at end of file
+}
+
+//fast four-quadrant arc tan function
+//input: any y, x; output: atan2<-pi,pi>[rad]; maximum error 1.2e-5 rad
+//the argument is reduced to the range <0,1> and atan is approximated with an odd polynomial of 9th degree
+float fastAtan2(float y, float x)
+{
+    const float QuarterPI = 0.78539816F;
+    const float HalfPI = 1.57079633F;
+    const float PI = 3.14159265F;
+    float absY = fabsf(y);
+    float absX = fabsf(x);
+    if((absX == 0.0F) && (absY == 0.0F))
+    {
+        return 0.0F;
+    }
+
+    bool isSwapped = absY > absX;
+    float z = isSwapped ? absX / absY : absY / absX;
+    float z2 = z * z;
+    float atan = z * (0.9998660F + z2 * (-0.3302995F + z2 * (0.1801410F + z2 * (-0.0851330F + z2 * 0.0208351F))));     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    atan = (atan > QuarterPI) ? QuarterPI : atan;
+
+    if(isSwapped)
+    {
+        atan = HalfPI - atan;
+    }
+    if(x < 0.0F)
+    {
+        atan = PI - atan;
+    }
+    return (y < 0.0F) ? -atan : atan;
+}
+
+//fast arc sin function
+//input: <-1,1>; output: asin<-pi/2,pi/2>[rad]; maximum error 1.4e-5 rad
+float fastAsin(float value)
+{
+    return fastAtan2(value, fastSqrt(1.0F - value * value));
+}
+
+//fast reciprocal square root
+//input: (0, inf); maximum relative error 5e-6
+//initial approximation from the float bit pattern refined with 2 Newton-Raphson iterations
+float fastInvSqrt(float value)
+{
+    const uint32_t MagicNumber = 0x5F375A86U;
+    uint32_t bits{0};
+    memcpy(&bits, &value, sizeof(bits));
+    bits = MagicNumber - (bits >> 1U);
+    float result{0.0F};
+    memcpy(&result, &bits, sizeof(result));
+    float halfValue = 0.5F * value;     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    result *= 1.5F - halfValue * result * result;       //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    result *= 1.5F - halfValue * result * result;       //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    return result;
+}
+
+//fast sine function using lookup table with linear interpolation
+//input: angle [rad], |angle| <= 100; maximum error 1e-5 for |angle| <= pi, 2e-5 for |angle| <= 100
+//quarter-wave table with 128 intervals; the other quadrants are mirrored
+//the table values are sin scaled by 2 / (1 + cos(step / 2)), which splits the interpolation error equally
+//between the table points and the interval middles; the result can exceed 1 by 1e-5
+//at large angles the error grows with the float resolution of the table position
+float fastSin(float angle)
+{
+    static constexpr std::array<float, 129> SineTable
+    {
+        0.0000000F, 0.0122717F, 0.0245415F, 0.0368076F, 0.0490681F, 0.0613213F, 0.0735653F, 0.0857981F,
+        0.0980181F, 0.1102232F, 0.1224118F, 0.1345820F, 0.1467319F, 0.1588596F, 0.1709635F, 0.1830416F,
+        0.1950922F, 0.2071133F, 0.2191033F, 0.2310603F, 0.2429825F, 0.2548681F, 0.2667153F, 0.2785223F,
+        0.2902874F, 0.3020088F, 0.3136847F, 0.3253134F, 0.3368930F, 0.3484220F, 0.3598984F, 0.3713207F,
+        0.3826870F, 0.3939957F, 0.4052451F, 0.4164335F, 0.4275591F, 0.4386204F, 0.4496156F, 0.4605430F,
+        0.4714012F, 0.4821883F, 0.4929028F, 0.5035431F, 0.5141076F, 0.5245946F, 0.5350027F, 0.5453301F,
+        0.5555755F, 0.5657371F, 0.5758136F, 0.5858034F, 0.5957049F, 0.6055167F, 0.6152374F, 0.6248654F,
+        0.6343993F, 0.6438376F, 0.6531790F, 0.6624220F, 0.6715653F, 0.6806074F, 0.6895470F, 0.6983828F,
+        0.7071134F, 0.7157376F, 0.7242539F, 0.7326612F, 0.7409581F, 0.7491434F, 0.7572160F, 0.7651745F,
+        0.7730177F, 0.7807446F, 0.7883538F, 0.7958444F, 0.8032151F, 0.8104648F, 0.8175925F, 0.8245971F,
+        0.8314774F, 0.8382326F, 0.8448615F, 0.8513632F, 0.8577367F, 0.8639810F, 0.8700952F, 0.8760783F,
+        0.8819296F, 0.8876480F, 0.8932327F, 0.8986829F, 0.9039978F, 0.9091765F, 0.9142184F, 0.9191225F,
+        0.9238882F, 0.9285148F, 0.9330016F, 0.9373478F, 0.9415529F, 0.9456162F, 0.9495371F, 0.9533150F,
+        0.9569493F, 0.9604396F, 0.9637851F, 0.9669856F, 0.9700404F, 0.9729491F, 0.9757113F, 0.9783266F,
+        0.9807945F, 0.9831147F, 0.9852869F, 0.9873107F, 0.9891858F, 0.9909120F, 0.9924889F, 0.9939163F,
+        0.9951941F, 0.9963220F, 0.9972998F, 0.9981275F, 0.9988049F, 0.9993318F, 0.9997082F, 0.9999341F,
+        1.0000094F
+    };      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const float StepsPerRadian = 81.4873309F;      // 256 / pi
+    const uint32_t QuarterSteps = 128;
+    const uint32_t QuadrantShift = 7;
+    const uint32_t QuadrantMask = 0x03U;
+
+    float position = angle * StepsPerRadian;
+    auto step = static_cast<int32_t>(position);
+    float fraction = position - static_cast<float>(step);
+    if(fraction < 0.0F)
+    {
+        // truncation of negative position; the fraction must be in the range <0,1)
+        fraction += 1.0F;
+        step--;
+    }
+    auto unsignedStep = static_cast<uint32_t>(step);
+    uint32_t index = unsignedStep & (QuarterSteps - 1);
+    uint32_t quadrant = (unsignedStep >> QuadrantShift) & QuadrantMask;
+
+    float value{0.0F};
+    if((quadrant & 1U) == 0)
+    {
+        // first and third quadrant - rising sine
+        value = SineTable[index] + (SineTable[index + 1] - SineTable[index]) * fraction;
+    }
+    else
+    {
+        // second and fourth quadrant - falling sine
+        value = SineTable[QuarterSteps - index] + (SineTable[QuarterSteps - index - 1] - SineTable[QuarterSteps - index]) * fraction;
+    }
+    return ((quadrant & 2U) == 0) ? value : -value;
+}
+
+//fast cosine function using lookup table with linear interpolation
+//input: angle [rad], |angle| <= 100; maximum error 1e-5 for |angle| <= pi, 2e-5 for |angle| <= 100
+float fastCos(float angle)
+{
+    const float HalfPI = 1.57079633F;
+    return fastSin(angle + HalfPI);
+}
@@ -14,6 +14,13 @@
 #define LO8(x)  static_cast<uint8_t>((x)&0xFFU) // NOLINT(hicpp-signed-bitwise)
 #define HI8(x)  static_cast<uint8_t>(((x)&0xFF00U)>>8U) // NOLINT(hicpp-signed-bitwise)
 
+template<typename T> struct Vector3D    //NOLINT(altera-struct-pack-align)
+{
+    T X;
+    T Y;
+    T Z;
+};
+
 //crops float type angle to the range 0...360 degrees
 float cropAngle(float angle);
 
@@ -103,4 +110,31 @@ template <typename T> unsigned char getParityBit(T data)
 //input: tan<-inf, inf>; output: atan<-90,90>[degrees]
 float fastAtan(float tan);
 
+//fast four-quadrant arc tan function
+//input: any y, x; output: atan2<-pi,pi>[rad]; maximum error 1.2e-5 rad
+float fastAtan2(float y, float x);
+
+//fast arc sin function
+//input: <-1,1>; output: asin<-pi/2,pi/2>[rad]; maximum error 1.4e-5 rad
+float fastAsin(float value);
+
+//fast reciprocal square root
+//input: (0, inf); maximum relative error 5e-6
+float fastInvSqrt(float value);
+
+//fast square root
+//input: <0, inf); maximum relative error 5e-6
+inline float fastSqrt(float value)
+{
+    return (value > 0.0F) ? value * fastInvSqrt(value) : 0.0F;
+}
+
+//fast sine function using lookup table with linear interpolation
+//input: angle [rad], |angle| <= 100; maximum error 1e-5 for |angle| <= pi, 2e-5 for |angle| <= 100
+float fastSin(float angle);
+
+//fast cosine function using lookup table with linear interpolation
+//input: angle [rad], |angle| <= 100; maximum error 1e-5 for |angle| <= pi, 2e-5 for |angle| <= 100
+float fastCos(float angle);
+
 #endif /* CONVERT_H_ */
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "Debouncer.h"
+
+Debouncer::Debouncer()
+{
+    constexpr std::chrono::microseconds SamplingPeriod = 1ms;
+    ticker.attach(callback(this, &Debouncer::onTick), SamplingPeriod);
+}
+
+Debouncer& Debouncer::getInstance()
+{
+    static Debouncer instance;    // Guaranteed to be destroyed, instantiated on first use
+    return instance;
+}
+
+/*
+configure the pin as input and start debouncing it from its current level
+*/
+void Debouncer::addPin(PinName pin, PinMode mode)
+{
+    CriticalSectionLock lock;
+    snapshot.addPin(pin, mode);
+    size_t port = STM_PORT(pin);
+    uint32_t pinMask = 1U << STM_PIN(pin);
+    debouncedLevels[port] = (debouncedLevels[port] & ~pinMask) | (snapshot.getLevels()[port] & pinMask);
+}
+
+/*
+register the listener of the debounced level changes of the pin
+*/
+void Debouncer::addListener(PinName pin, Callback<void(const PortLevels&)> listener)
+{
+    CriticalSectionLock lock;
+    listeners.push_back({pin, listener});
+}
+
+/*
+register the consumer of the raw samples of all ports
+*/
+void Debouncer::addSampler(Callback<void(const PortLevels&)> sampler)
+{
+    CriticalSectionLock lock;
+    samplers.push_back(sampler);
+}
+
+/*
+get the debounced levels of all ports
+*/
+void Debouncer::getLevels(PortLevels& levels) const
+{
+    CriticalSectionLock lock;
+    levels = debouncedLevels;
+}
+
+/*
+sample all ports and update the vertical counters (ISR context)
+a pin counter counts the consecutive samples differing from the debounced level and is cleared by an equal sample;
+the debounced level toggles when the counter wraps around after 4 samples
+*/
+void Debouncer::onTick()
+{
+    snapshot.capture();
+    const PortLevels& samples = snapshot.getLevels();
+    for(auto& sampler : samplers)
+    {
+        sampler(samples);
+    }
+
+    PortLevels changes{};
+    bool isChanged = false;
+    for(size_t port = 0; port < NumberOfGpioPorts; port++)
+    {
+        uint32_t delta = (samples[port] ^ debouncedLevels[port]) & snapshot.getUsedPinMask(port);
+        counterBit1[port] = (counterBit1[port] ^ counterBit0[port]) & delta;
+        counterBit0[port] = ~counterBit0[port] & delta;
+        changes[port] = delta & ~(counterBit0[port] | counterBit1[port]);
+        debouncedLevels[port] ^= changes[port];
+        isChanged = isChanged || (changes[port] != 0);
+    }
+
+    if(isChanged)
+    {
+        for(auto& listener : listeners)
+        {
+            if(getPinLevel(changes, listener.pin) != 0)
+            {
+                listener.callback(debouncedLevels);
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef DEBOUNCER_H_
+#define DEBOUNCER_H_
+
+#include "GpioSnapshot.h"
+#include <mbed.h>
+#include <vector>
+
+/*
+Debouncer of all switch inputs
+the GPIO ports are sampled periodically and every pin is debounced in parallel with 2-bit vertical counters:
+a debounced level changes after 4 consecutive samples of the opposite level (4 ms),
+so the interrupt load is one ticker interrupt per period regardless of the switch bouncing
+the listeners are called in the ticker interrupt context with the debounced levels when any of their pins has changed;
+the samplers are called in the ticker interrupt context with the raw levels of every sample
+*/
+class Debouncer
+{
+public:
+    static Debouncer& getInstance();
+    Debouncer(Debouncer const&) = delete;   // copy constructor removed for singleton
+    void operator=(Debouncer const&) = delete;
+    Debouncer(Debouncer&&) = delete;
+    void operator=(Debouncer&&) = delete;
+    void addPin(PinName pin, PinMode mode);
+    template<size_t NumberOfPins> void addPins(const std::array<PinName, NumberOfPins>& pins, PinMode mode)
+    {
+        for(auto pin : pins)
+        {
+            addPin(pin, mode);
+        }
+    }
+    void addListener(PinName pin, Callback<void(const PortLevels&)> listener);
+    void addSampler(Callback<void(const PortLevels&)> sampler);
+    void getLevels(PortLevels& levels) const;
+private:
+    Debouncer();
+    ~Debouncer() = default;
+    void onTick();
+    struct Listener
+    {
+        PinName pin;
+        Callback<void(const PortLevels&)> callback;
+    };
+    GpioSnapshot snapshot;
+    PortLevels debouncedLevels{};   // debounced levels of all ports
+    PortLevels counterBit0{};       // vertical counters: bit 0 of every pin counter
+    PortLevels counterBit1{};       // vertical counters: bit 1 of every pin counter
+    std::vector<Listener> listeners;
+    std::vector<Callback<void(const PortLevels&)>> samplers;
+    Ticker ticker;
+};
+
+#endif /* DEBOUNCER_H_ */
@@ -1,28 +1,11 @@
 #include "Filter.h"
-
-FilterSMA::FilterSMA(size_t filterSize) :
-    filterSize(filterSize),
-    dataBuffer(filterSize, 0.0F)
-{
-    MBED_ASSERT(filterSize);
-    filterFactor = 1.0F / static_cast<float>(filterSize);
-}
-
-/*
-calculate filter value for a new input value
-*/
-void FilterSMA::calculate(float input)
-{
-    filterValue += filterFactor * (input - dataBuffer[currentElement]);
-    dataBuffer[currentElement] = input;
-    currentElement = (currentElement + 1) % filterSize;
-}
+#include <cmath>
 
 void FilterAEMA::calculate(float input)
 {
     float delta = input - filterValue;
     filteredDeviation = filteredDeviation * (1.0F - DeviationFilterStrength) + fabs(delta) * DeviationFilterStrength;
-    float alpha = FilterStrength * fabs(delta) / filteredDeviation;
+    float alpha = filterStrength * fabs(delta) / filteredDeviation;
     if(alpha > 1.0F)
     {
         alpha = 1.0F;
@@ -35,57 +18,62 @@ void FilterEMA::calculate(float input)
     filterValue += filterFactor * (input - filterValue);
 }
 
-FilterMM::FilterMM(size_t size) :
-    size(size)
-{
-    unsortedBuffer.assign(size, 0.0F);
-    sortedBuffer.assign(size, 0.0F);
-}
-
-void FilterMM::calculate(float newInputValue)
+// the filter value is kept in a register for the whole block
+void FilterEMA::calculate(mbed::Span<const float> inputs)
 {
-    // delete the oldest element from the sorted buffer
-    float oldestValue = unsortedBuffer[headIndex];
-    for (auto element = sortedBuffer.begin(); element != sortedBuffer.end(); element++)
+    float value = filterValue;
+    for(float input : inputs)
     {
-        if (*element == oldestValue)
-        {
-            sortedBuffer.erase(element);
-            break;
-        }
+        value += filterFactor * (input - value);
     }
+    filterValue = value;
+}
 
-    // emplace the new element
-    size_t step = size / 2;
-    size_t searchIndex = size / 2;
-    while ((searchIndex > 0) && (searchIndex < sortedBuffer.size()))
-    {
-        if (step > 1)
-        {
-            step /= 2;
-        }
+std::complex<float> BiquadCoefficients::getResponse(float omega) const
+{
+    std::complex<float> z1 = std::polar(1.0F, -omega);      // z^-1
+    std::complex<float> z2 = z1 * z1;                       // z^-2
+    return (b0 + b1 * z1 + b2 * z2) / (1.0F + a1 * z1 + a2 * z2);
+}
 
-        if (newInputValue > sortedBuffer[searchIndex])
-        {
-            searchIndex += step;
-        }
-        else
-        {
-            if (newInputValue > sortedBuffer[searchIndex - 1])
-            {
-                break;
-            }
-            searchIndex -= step;
-        }
-    }
-    if (searchIndex >= sortedBuffer.size())
-    {
-        sortedBuffer.push_back(newInputValue);
-    }
-    else
+/*
+design a biquad section of the given type
+the frequency is limited below the Nyquist frequency
+*/
+BiquadCoefficients designBiquad(BiquadType type, float frequency, float sampleRate, float q)
+{
+    MBED_ASSERT((sampleRate > 0.0F) && (q > 0.0F));
+    constexpr float TwoPI = 6.2831853F;
+    constexpr float MaxRelativeFrequency = 0.49F;
+    float omega = TwoPI * std::min(std::max(frequency, 0.0F), MaxRelativeFrequency * sampleRate) / sampleRate;
+    float cosOmega = cosf(omega);
+    float alpha = sinf(omega) / (2.0F * q);
+    float a0 = 1.0F + alpha;
+    float b0{0.0F};
+    float b1{0.0F};
+    float b2{0.0F};
+    switch(type)
     {
-        sortedBuffer.insert(sortedBuffer.begin() + searchIndex, newInputValue);     //NOLINT(bugprone-narrowing-conversions,cppcoreguidelines-narrowing-conversions)
+    case BiquadType::LowPass:
+        b1 = 1.0F - cosOmega;
+        b0 = b2 = b1 / 2.0F;
+        break;
+    case BiquadType::HighPass:
+        b1 = -(1.0F + cosOmega);
+        b0 = b2 = -b1 / 2.0F;
+        break;
+    case BiquadType::Notch:
+        b0 = b2 = 1.0F;
+        b1 = -2.0F * cosOmega;
+        break;
     }
-    unsortedBuffer[headIndex] = newInputValue;
-    headIndex = (headIndex + 1) % size;
+    return BiquadCoefficients{b0 / a0, b1 / a0, b2 / a0, -2.0F * cosOmega / a0, (1.0F - alpha) / a0};
+}
+
+// the poles of the Butterworth filter of the order n lie on a circle at the angles (2k+1)*pi/(2n) from the imaginary axis
+float getButterworthQ(size_t section, size_t numberOfSections)
+{
+    constexpr float PI = 3.14159265F;
+    float angle = PI * static_cast<float>(2 * section + 1) / static_cast<float>(4 * numberOfSections);
+    return 1.0F / (2.0F * sinf(angle));
 }
@@ -1,24 +1,172 @@
 #ifndef FILTER_H_
 #define FILTER_H_
 
-#include <mbed.h>
+#include "platform/mbed_assert.h"
+#include "platform/Span.h"
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+constexpr size_t DynamicFilterSize = 0;     // window size of the filters sized at run time
+
+// next index of a ring buffer; the power-of-two sizes wrap with a mask
+template<size_t Size> constexpr size_t nextRingIndex(size_t index)
+{
+    return ((Size & (Size - 1)) == 0) ? ((index + 1) & (Size - 1)) : ((index + 1 == Size) ? 0 : index + 1);
+}
+
+inline size_t nextRingIndex(size_t index, size_t size) { return (index + 1 == size) ? 0 : index + 1; }
+
+// sum of the filter window and the average of the sum; the integer samples are summed in a wider integer type
+template<typename T, bool = std::is_floating_point<T>::value> struct FilterAccumulator
+{
+    using Type = T;
+    static constexpr T average(Type sum, size_t size) { return sum * (T{1} / static_cast<T>(size)); }
+};
+
+template<typename T> struct FilterAccumulator<T, false>
+{
+    using Type = typename std::conditional<(sizeof(T) < sizeof(int32_t)), int32_t, int64_t>::type;
+    static constexpr T average(Type sum, size_t size) { return static_cast<T>(sum / static_cast<Type>(size)); }
+};
+
+/*
+sum of a block of samples
+the samples are summed in four independent partial sums, so the compiler can vectorise the loop;
+on Cortex-M4/M7 the 16-bit samples are summed in pairs with the dual 16-bit multiply-accumulate instruction
+*/
+template<typename T> typename FilterAccumulator<T>::Type sumBlock(const T* samples, size_t count)
+{
+    using Accumulator = typename FilterAccumulator<T>::Type;
+    constexpr size_t Lanes = 4;
+    std::array<Accumulator, Lanes> partialSums{};
+    size_t index = 0;
+    for(; index + Lanes <= count; index += Lanes)
+    {
+        for(size_t lane = 0; lane < Lanes; lane++)
+        {
+            partialSums[lane] += static_cast<Accumulator>(samples[index + lane]);
+        }
+    }
+    Accumulator sum = (partialSums[0] + partialSums[1]) + (partialSums[2] + partialSums[3]);
+    for(; index < count; index++)
+    {
+        sum += static_cast<Accumulator>(samples[index]);
+    }
+    return sum;
+}
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis.h"
+
+template<> inline int32_t sumBlock<int16_t>(const int16_t* samples, size_t count)
+{
+    constexpr uint32_t PairOfOnes = 0x00010001U;
+    uint32_t sum = 0;
+    size_t index = 0;
+    for(; index + 2 <= count; index += 2)
+    {
+        uint32_t pair{0};
+        std::memcpy(&pair, &samples[index], sizeof(pair));      // one word load; Cortex-M4/M7 allow unaligned access
+        sum = __SMLAD(pair, PairOfOnes, sum);
+    }
+    auto result = static_cast<int32_t>(sum);
+    if(index < count)
+    {
+        result += samples[index];
+    }
+    return result;
+}
+#endif
+
 /*
-Simple Moving Average filter
+add a block of samples to a moving average window in the ring buffer
+the window is updated in contiguous ring segments, so there is no wrap check per sample;
+a block at least as long as the window replaces the whole window and the sum is recalculated
 */
-class FilterSMA
+template<typename T> void addBlockToWindow(T* buffer, size_t size, size_t& currentElement, typename FilterAccumulator<T>::Type& sum, mbed::Span<const T> inputs)
+{
+    auto count = static_cast<size_t>(inputs.size());
+    const T* samples = inputs.data();
+    if(count >= size)
+    {
+        samples += count - size;
+        std::copy(samples, samples + size, buffer);
+        currentElement = 0;
+        sum = sumBlock(samples, size);
+        return;
+    }
+    while(count > 0)
+    {
+        size_t segment = std::min(count, size - currentElement);
+        sum += sumBlock(samples, segment) - sumBlock(buffer + currentElement, segment);
+        std::copy(samples, samples + segment, buffer + currentElement);
+        currentElement = (currentElement + segment == size) ? 0 : currentElement + segment;
+        samples += segment;
+        count -= segment;
+    }
+}
+
+/*
+Simple Moving Average filter of the sample type T
+the window size is a template parameter, so the buffer is a member array and the averaging factor is a constant;
+FilterMovingAverage<T> (size DynamicFilterSize) gets the window size in the constructor
+the block calculation gives the same value as the samples calculated one by one (up to the floating-point rounding)
+*/
+template<typename T = float, size_t Size = DynamicFilterSize> class FilterMovingAverage
 {
 public:
-    explicit FilterSMA(size_t filterSize);
-    void calculate(float input);
-    float getValue() const { return filterValue; }
+    void calculate(T input)
+    {
+        sum += static_cast<Accumulator>(input) - static_cast<Accumulator>(dataBuffer[currentElement]);
+        dataBuffer[currentElement] = input;
+        currentElement = nextRingIndex<Size>(currentElement);
+    }
+    void calculate(mbed::Span<const T> inputs) { addBlockToWindow(dataBuffer.data(), Size, currentElement, sum, inputs); }
+    T getValue() const { return FilterAccumulator<T>::average(sum, Size); }
 private:
-    size_t filterSize;                      // size of the averaging buffer
-    std::vector<float> dataBuffer;          // data buffer for filter calculations
+    using Accumulator = typename FilterAccumulator<T>::Type;
+    std::array<T, Size> dataBuffer{};       // data buffer for filter calculations
     size_t currentElement{0};               // index of the current element
-    float filterValue{0.0F};                // current filter value
-    float filterFactor{0.0F};               // reciprocal of filter size for calculation purposes
+    Accumulator sum{0};                     // sum of the buffer values
+};
+
+template<typename T> class FilterMovingAverage<T, DynamicFilterSize>
+{
+public:
+    explicit FilterMovingAverage(size_t filterSize) :
+        dataBuffer(filterSize, T{0})
+    {
+        MBED_ASSERT(filterSize);
+    }
+    void calculate(T input)
+    {
+        sum += static_cast<Accumulator>(input) - static_cast<Accumulator>(dataBuffer[currentElement]);
+        dataBuffer[currentElement] = input;
+        currentElement = nextRingIndex(currentElement, dataBuffer.size());
+    }
+    void calculate(mbed::Span<const T> inputs) { addBlockToWindow(dataBuffer.data(), dataBuffer.size(), currentElement, sum, inputs); }
+    T getValue() const { return FilterAccumulator<T>::average(sum, dataBuffer.size()); }
+private:
+    using Accumulator = typename FilterAccumulator<T>::Type;
+    std::vector<T> dataBuffer;              // data buffer for filter calculations
+    size_t currentElement{0};               // index of the current element
+    Accumulator sum{0};                     // sum of the buffer values
+};
+
+/*
+Simple Moving Average filter of the float samples with the window size given at run time
+*/
+class FilterSMA : public FilterMovingAverage<float>
+{
+public:
+    explicit FilterSMA(size_t filterSize) : FilterMovingAverage<float>(filterSize) {}
 };
 
 /*
@@ -29,8 +177,11 @@ class FilterAEMA
 public:
     void calculate(float input);
     float getValue() const { return filterValue; }
+    float getStrength() const { return filterStrength; }
+    void setStrength(float strength) { filterStrength = strength; }
+    void reset() { filterValue = filteredDeviation = 0.0F; }
 private:
-    const float FilterStrength = 0.03F;
+    float filterStrength{0.03F};      // filter strength at the average deviation
     float filterValue{0.0F};      // current filtered value
     const float DeviationFilterStrength = 0.02F;        // filter strength for average deviation calculations
     float filteredDeviation{0.0F};  // current filtered deviation value 
@@ -44,25 +195,291 @@ class FilterEMA
 public:
     explicit FilterEMA(float filterFactor) : filterFactor(filterFactor) {}
     void calculate(float input);
+    void calculate(mbed::Span<const float> inputs);
     float getValue() const { return filterValue; }
+    float getFactor() const { return filterFactor; }
+    void setFactor(float factor) { filterFactor = factor; }
+    void reset() { filterValue = 0.0F; }
+private:
+    float filterFactor;
+    float filterValue{0.0F};      // current filtered value
+};
+
+/*
+bank of Regular Exponential Moving Average filters of interleaved channels
+the filter values of all channels are kept in one array (structure of arrays), so a scan updates all channels
+in one loop without dependencies between the iterations, which the compiler can vectorise
+*/
+template<size_t Channels> class FilterEMABank
+{
+public:
+    explicit FilterEMABank(float filterFactor) : filterFactor(filterFactor) {}
+    // process the scans of the channel samples; an incomplete last scan is ignored
+    void calculate(mbed::Span<const float> scans)
+    {
+        size_t numberOfScans = static_cast<size_t>(scans.size()) / Channels;
+        const float* samples = scans.data();
+        for(size_t scan = 0; scan < numberOfScans; scan++)
+        {
+            for(size_t channel = 0; channel < Channels; channel++)
+            {
+                filterValues[channel] += filterFactor * (samples[channel] - filterValues[channel]);
+            }
+            samples += Channels;
+        }
+    }
+    float getValue(size_t channel) const { return filterValues[channel]; }
+    const std::array<float, Channels>& getValues() const { return filterValues; }
     void setFactor(float factor) { filterFactor = factor; }
 private:
     float filterFactor;
+    std::array<float, Channels> filterValues{};     // current filtered values of the channels
+};
+
+// coefficients of a biquad section normalized to a0 = 1
+struct BiquadCoefficients
+{
+    float b0{1.0F};
+    float b1{0.0F};
+    float b2{0.0F};
+    float a1{0.0F};
+    float a2{0.0F};
+    // frequency response of the section at the normalized angular frequency [rad/sample]
+    std::complex<float> getResponse(float omega) const;
+};
+
+enum struct BiquadType
+{
+    LowPass,
+    HighPass,
+    Notch
+};
+
+/*
+design a biquad section with the bilinear transform of the analog prototype
+the frequency is the cutoff frequency of the low-pass and high-pass sections or the center frequency of the notch [Hz]
+*/
+BiquadCoefficients designBiquad(BiquadType type, float frequency, float sampleRate, float q);
+
+// quality factor of a section of the Butterworth filter of the order 2*numberOfSections
+float getButterworthQ(size_t section, size_t numberOfSections);
+
+/*
+cascade of biquad sections in the transposed direct form II
+a Butterworth low-pass of the order 2*Sections has a flat pass band and at the same noise rejection
+a much lower lag than a first order EMA filter
+the coefficients can be designed again at run time, e.g. for a changed sample rate; the filter state is kept
+*/
+template<size_t Sections> class FilterBiquad
+{
+public:
+    void designLowPass(float cutoffFrequency, float sampleRate) { designButterworth(BiquadType::LowPass, cutoffFrequency, sampleRate); }
+    void designHighPass(float cutoffFrequency, float sampleRate) { designButterworth(BiquadType::HighPass, cutoffFrequency, sampleRate); }
+    // all sections have the notch at the same frequency; q is the center frequency divided by the bandwidth
+    void designNotch(float centerFrequency, float sampleRate, float q)
+    {
+        for(auto& section : sections)
+        {
+            section = designBiquad(BiquadType::Notch, centerFrequency, sampleRate, q);
+        }
+    }
+    void calculate(float input)
+    {
+        float value = input;
+        for(size_t index = 0; index < Sections; index++)
+        {
+            const BiquadCoefficients& section = sections[index];
+            std::array<float, 2>& state = states[index];
+            float output = section.b0 * value + state[0];
+            state[0] = section.b1 * value - section.a1 * output + state[1];
+            state[1] = section.b2 * value - section.a2 * output;
+            value = output;
+        }
+        filterValue = value;
+    }
+    void calculate(mbed::Span<const float> inputs)
+    {
+        for(float input : inputs)
+        {
+            calculate(input);
+        }
+    }
+    float getValue() const { return filterValue; }
+    // set the state of a constant input, so the filter starts without a transient
+    void reset(float input)
+    {
+        float value = input;
+        for(size_t index = 0; index < Sections; index++)
+        {
+            const BiquadCoefficients& section = sections[index];
+            float output = value * (section.b0 + section.b1 + section.b2) / (1.0F + section.a1 + section.a2);
+            states[index][1] = section.b2 * value - section.a2 * output;
+            states[index][0] = section.b1 * value - section.a1 * output + states[index][1];
+            value = output;
+        }
+        filterValue = value;
+    }
+    // frequency response of the cascade at the frequency [Hz]
+    std::complex<float> getResponse(float frequency, float sampleRate) const
+    {
+        constexpr float TwoPI = 6.2831853F;
+        std::complex<float> response{1.0F, 0.0F};
+        for(const auto& section : sections)
+        {
+            response *= section.getResponse(TwoPI * frequency / sampleRate);
+        }
+        return response;
+    }
+    const std::array<BiquadCoefficients, Sections>& getCoefficients() const { return sections; }
+private:
+    void designButterworth(BiquadType type, float cutoffFrequency, float sampleRate)
+    {
+        for(size_t index = 0; index < Sections; index++)
+        {
+            sections[index] = designBiquad(type, cutoffFrequency, sampleRate, getButterworthQ(index, Sections));
+        }
+    }
+    std::array<BiquadCoefficients, Sections> sections{};        // pass-through sections until designed
+    std::array<std::array<float, 2>, Sections> states{};        // delayed state of every section
     float filterValue{0.0F};      // current filtered value
 };
 
-class FilterMM
+/*
+Moving Median filter
+the window values are kept in two indexable heaps: a max-heap of the lower half and a min-heap of the upper half
+of the window, so the median is the root of the upper heap
+every ring slot knows its heap position, so the oldest value is replaced in place with O(log n) heap moves
+the buffers are std::array members of FilterMovingMedian<T, Size> or vectors allocated in the constructor of FilterMovingMedian<T>
+*/
+template<typename T, typename Values, typename Indexes> class MedianHeaps
 {
 public:
-    explicit FilterMM(size_t size);
-    void displayBuffer();
-    float getValue() { return sortedBuffer[size / 2]; }
-    void calculate(float newInputValue);
+    T getValue() const { return values[heap[lowerSize]]; }
+
+    /*
+    replace the oldest window value with the new value
+    the changed value is restored in its own heap first; if it crossed the median, the roots of the heaps are exchanged
+    and both restored again
+    */
+    void calculate(T newInputValue)
+    {
+        size_t position = positions[headIndex];
+        values[headIndex] = newInputValue;
+        siftUp(position);
+        siftDown(positions[headIndex]);
+        if((lowerSize > 0) && (values[heap[0]] > values[heap[lowerSize]]))
+        {
+            swapPositions(0, lowerSize);
+            siftDown(0);
+            siftDown(lowerSize);
+        }
+        headIndex = nextRingIndex(headIndex, values.size());
+    }
+protected:
+    MedianHeaps(Values values, Indexes heap, Indexes positions) :
+        values(std::move(values)),
+        heap(std::move(heap)),
+        positions(std::move(positions)),
+        lowerSize(this->values.size() / 2)
+    {
+        MBED_ASSERT(this->values.size());
+        // all values are equal at start, so any slot order satisfies both heaps
+        for(size_t slot = 0; slot < this->values.size(); slot++)
+        {
+            this->heap[slot] = static_cast<typename Indexes::value_type>(slot);
+            this->positions[slot] = static_cast<typename Indexes::value_type>(slot);
+        }
+    }
 private:
-    size_t size;
-    size_t headIndex{ 0 };
-    std::vector<float> unsortedBuffer;
-    std::vector<float> sortedBuffer;
+    bool isLower(size_t position) const { return position < lowerSize; }
+
+    // the value at the first heap position belongs closer to the root than the value at the second position
+    bool isAbove(size_t first, size_t second) const
+    {
+        T firstValue = values[heap[first]];
+        T secondValue = values[heap[second]];
+        return isLower(first) ? (firstValue > secondValue) : (firstValue < secondValue);
+    }
+
+    void swapPositions(size_t first, size_t second)
+    {
+        std::swap(heap[first], heap[second]);
+        positions[heap[first]] = static_cast<typename Indexes::value_type>(first);
+        positions[heap[second]] = static_cast<typename Indexes::value_type>(second);
+    }
+
+    // move the value towards the root of its heap
+    void siftUp(size_t position)
+    {
+        size_t base = isLower(position) ? 0 : lowerSize;
+        while(position > base)
+        {
+            size_t parent = base + (position - base - 1) / 2;
+            if(!isAbove(position, parent))
+            {
+                break;
+            }
+            swapPositions(position, parent);
+            position = parent;
+        }
+    }
+
+    // move the value towards the leaves of its heap
+    void siftDown(size_t position)
+    {
+        size_t base = isLower(position) ? 0 : lowerSize;
+        size_t end = isLower(position) ? lowerSize : values.size();
+        while(true)
+        {
+            size_t child = base + 2 * (position - base) + 1;
+            if(child >= end)
+            {
+                break;
+            }
+            if((child + 1 < end) && isAbove(child + 1, child))
+            {
+                child++;
+            }
+            if(!isAbove(child, position))
+            {
+                break;
+            }
+            swapPositions(position, child);
+            position = child;
+        }
+    }
+
+    Values values;              // window values in ring order
+    Indexes heap;               // ring slots of the lower heap at positions 0..lowerSize-1 followed by the upper heap
+    Indexes positions;          // heap position of every ring slot
+    size_t lowerSize;           // number of values in the lower heap; the upper heap holds the rest
+    size_t headIndex{0};        // ring slot of the oldest value
+};
+
+// heap index type of the window size
+template<size_t Size> using MedianIndex = typename std::conditional<(Size <= UINT8_MAX + 1), uint8_t, uint16_t>::type;
+
+template<typename T = float, size_t Size = DynamicFilterSize>
+class FilterMovingMedian : public MedianHeaps<T, std::array<T, Size>, std::array<MedianIndex<Size>, Size>>
+{
+public:
+    static_assert((Size > 0) && (Size <= UINT16_MAX + 1), "median filter size out of range");
+    FilterMovingMedian() : MedianHeaps<T, std::array<T, Size>, std::array<MedianIndex<Size>, Size>>({}, {}, {}) {}
+};
+
+template<typename T> class FilterMovingMedian<T, DynamicFilterSize> : public MedianHeaps<T, std::vector<T>, std::vector<size_t>>
+{
+public:
+    explicit FilterMovingMedian(size_t size) : MedianHeaps<T, std::vector<T>, std::vector<size_t>>(std::vector<T>(size, T{0}), std::vector<size_t>(size), std::vector<size_t>(size)) {}
+};
+
+/*
+Moving Median filter of the float samples with the window size given at run time
+*/
+class FilterMM : public FilterMovingMedian<float>
+{
+public:
+    explicit FilterMM(size_t size) : FilterMovingMedian<float>(size) {}
 };
 
 #endif /* FILTER_H_ */
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "FixedPoint.h"
+#include <array>
+
+/*
+integer square root rounded down
+bit-by-bit calculation without division
+*/
+uint32_t fixedSqrt(uint32_t value)
+{
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;       //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    while(bit > value)
+    {
+        bit >>= 2;
+    }
+    while(bit != 0)
+    {
+        if(value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+/*
+four-quadrant arctangent returning binary angle
+the argument is reduced to the octant <0,1> with a single division,
+then atan(z)/pi is approximated with an odd polynomial of 9th degree evaluated in Q30
+maximum error is about 3e-5 rad, limited by the Q16 resolution of the division result
+*/
+int32_t fixedAtan2(int32_t y, int32_t x)
+{
+    // polynomial coefficients of atan(z)/pi in Q30: 0.9998660, -0.3302995, 0.1801410, -0.0851330, 0.0208351 divided by pi
+    static constexpr std::array<int64_t, 5> Coefficients{ 341736839, -112890634, 61569066, -29096981, 7121075 };    //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    constexpr int Q30Shift = 30;
+    constexpr int32_t QuarterAngle = 1L << 29;      // pi/4     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    constexpr int32_t HalfAngle = 1L << 30;         // pi/2     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    if((x == 0) && (y == 0))
+    {
+        return 0;
+    }
+
+    uint32_t absX = (x < 0) ? 0U - static_cast<uint32_t>(x) : static_cast<uint32_t>(x);
+    uint32_t absY = (y < 0) ? 0U - static_cast<uint32_t>(y) : static_cast<uint32_t>(y);
+    bool isSwapped = absY > absX;
+    uint32_t numerator = isSwapped ? absX : absY;
+    uint32_t denominator = isSwapped ? absY : absX;
+
+    // z = numerator / denominator in Q30 (via Q16 division to keep it in 32 bits)
+    while(numerator > 0xFFFFU)      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    {
+        numerator >>= 1;
+        denominator >>= 1;
+    }
+    int64_t z = static_cast<int64_t>((numerator << 16) / denominator) << 14;    //NOLINT(hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    int64_t z2 = (z * z) >> Q30Shift;     //NOLINT(hicpp-signed-bitwise)
+
+    int64_t polynomial = Coefficients[4];
+    polynomial = Coefficients[3] + ((polynomial * z2) >> Q30Shift);     //NOLINT(hicpp-signed-bitwise)
+    polynomial = Coefficients[2] + ((polynomial * z2) >> Q30Shift);     //NOLINT(hicpp-signed-bitwise)
+    polynomial = Coefficients[1] + ((polynomial * z2) >> Q30Shift);     //NOLINT(hicpp-signed-bitwise)
+    polynomial = Coefficients[0] + ((polynomial * z2) >> Q30Shift);     //NOLINT(hicpp-signed-bitwise)
+    // atan/pi in Q30 converted to binary angle (Q31); the result is within <0,pi/4>
+    auto angle = static_cast<int32_t>(((polynomial * z) >> Q30Shift) << 1);      //NOLINT(hicpp-signed-bitwise)
+    angle = limit<int32_t>(angle, 0, QuarterAngle);
+
+    // restore the octant
+    if(isSwapped)
+    {
+        angle = HalfAngle - angle;
+    }
+    if(x < 0)
+    {
+        angle = subtractAngles(std::numeric_limits<int32_t>::min(), angle);     // pi - angle
+    }
+    return (y < 0) ? subtractAngles(0, angle) : angle;
+}
+
+/*
+sine of binary angle in Q15
+quarter-wave lookup table with 64 intervals and linear interpolation
+maximum error is about 1.5e-4 (5 LSB)
+*/
+int16_t fixedSin(int32_t angle)
+{
+    static constexpr std::array<int16_t, 65> SineTable
+    {
+        0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+        12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+        23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+        30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+        32767
+    };      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    constexpr int IndexShift = 24;                      // bits 29..24 of the angle select the table interval
+    constexpr uint32_t FractionMask = 0x00FFFFFFU;      // bits 23..0 of the angle are interpolated
+    constexpr uint32_t QuarterMask = 0x3FFFFFFFU;       // angle within the quadrant
+    constexpr uint32_t QuarterBit = 0x40000000U;        // odd quadrants are mirrored
+
+    auto unsignedAngle = static_cast<uint32_t>(angle);
+    bool isNegative = (unsignedAngle & 0x80000000U) != 0;     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    uint32_t quarterAngle = unsignedAngle & QuarterMask;
+    if((unsignedAngle & QuarterBit) != 0)
+    {
+        // sin(pi/2 + a) = sin(pi/2 - a)
+        quarterAngle = QuarterBit - quarterAngle;
+    }
+
+    uint32_t index = quarterAngle >> IndexShift;
+    int32_t value = SineTable[index];
+    if(index < SineTable.size() - 1)
+    {
+        int32_t difference = SineTable[index + 1] - value;
+        value += static_cast<int32_t>((static_cast<int64_t>(difference) * (quarterAngle & FractionMask)) >> IndexShift);     //NOLINT(hicpp-signed-bitwise)
+    }
+    return static_cast<int16_t>(isNegative ? -value : value);
+}
@@ -0,0 +1,152 @@
+#ifndef FIXEDPOINT_H_
+#define FIXEDPOINT_H_
+
+#include "Convert.h"
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/*
+Fixed-point arithmetic for the sensor fusion and axis scaling path
+Q15 - int16_t value in the range <-1,1)
+Q31 - int32_t value in the range <-1,1)
+binary angle - int32_t value, the full range represents angles <-pi,pi), so angles wrap around naturally
+*/
+
+constexpr float FixedPointPI = 3.14159265359F;
+constexpr float Q31Scale = 2147483648.0F;       // 2^31
+constexpr float Q15Scale = 32768.0F;            // 2^15
+
+// convert float value <-1,1) to Q31
+constexpr int32_t toQ31(float value) { return static_cast<int32_t>(value * Q31Scale); }
+
+// convert float value <-1,1) to Q15
+constexpr int16_t toQ15(float value) { return static_cast<int16_t>(value * Q15Scale); }
+
+// convert angle in radians <-pi,pi) to binary angle
+constexpr int32_t toBinaryAngle(float angle) { return static_cast<int32_t>(angle / FixedPointPI * Q31Scale); }
+
+// convert binary angle to radians
+inline float binaryAngleToRadians(int32_t angle) { return static_cast<float>(angle) * (FixedPointPI / Q31Scale); }
+
+// multiplication of Q31 numbers; the first argument can be of any fixed-point format
+inline int32_t multiplyQ31(int32_t value, int32_t factor)
+{
+    return static_cast<int32_t>((static_cast<int64_t>(value) * factor) >> 31);     //NOLINT(hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+}
+
+// multiplication of Q15 numbers; the first argument can be of any fixed-point format
+inline int32_t multiplyQ15(int32_t value, int16_t factor)
+{
+    return static_cast<int32_t>((static_cast<int64_t>(value) * factor) >> 15);     //NOLINT(hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+}
+
+// sum of binary angles with wrap-around
+inline int32_t addAngles(int32_t angle1, int32_t angle2)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(angle1) + static_cast<uint32_t>(angle2));
+}
+
+// difference of binary angles with wrap-around
+inline int32_t subtractAngles(int32_t angle1, int32_t angle2)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(angle1) - static_cast<uint32_t>(angle2));
+}
+
+// negation without overflow of the minimum value
+template<typename T> T saturatedNegate(T value)
+{
+    return (value == std::numeric_limits<T>::min()) ? std::numeric_limits<T>::max() : static_cast<T>(-value);
+}
+
+// saturate 32-bit value to 16-bit range
+inline int16_t saturate16(int32_t value)
+{
+    return static_cast<int16_t>(limit<int32_t>(value, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()));
+}
+
+uint32_t fixedSqrt(uint32_t value);
+int32_t fixedAtan2(int32_t y, int32_t x);
+int16_t fixedSin(int32_t angle);
+inline int16_t fixedCos(int32_t angle) { return fixedSin(addAngles(angle, toQ31(0.5F))); }   //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+/*
+scale factor of a binary angle to the joystick axis range <-32767,32767> at maxAngle [rad]
+to be used with scaleAngle()
+*/
+constexpr int32_t axisScale(float maxAngle) { return static_cast<int32_t>(FixedPointPI / maxAngle * 32767.0F); }     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+// scale binary angle to the joystick axis value with saturation
+inline int16_t scaleAngle(int32_t angle, int32_t scale, int16_t minValue, int16_t maxValue)
+{
+    auto result = static_cast<int32_t>((static_cast<int64_t>(angle) * scale) >> 31);    //NOLINT(hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    return static_cast<int16_t>(limit<int32_t>(result, minValue, maxValue));
+}
+
+/*
+Fixed-point complementary filter of the IMU sensor orientation
+fed with raw sensor samples of type SampleType already mapped to the body axes
+X = roll axis, Y = pitch axis, Z = yaw axis; the angles are binary angles
+the coefficients are calculated once in the constructor, the update uses integer arithmetic only
+*/
+template<typename SampleType> class FixedPointFusion
+{
+    static_assert(std::is_signed<SampleType>::value && (sizeof(SampleType) <= sizeof(int16_t)), "the sum of squared samples must fit in 32 bits");
+public:
+    // angularRateResolution [rad/s per LSB], samplePeriod [s], timeConstant [s]
+    FixedPointFusion(float angularRateResolution, float samplePeriod, float timeConstant) :
+        rateGain(static_cast<int32_t>(angularRateResolution * samplePeriod / FixedPointPI * Q31Scale * RateGainScale)),
+        filterFactor(toQ31(samplePeriod / (timeConstant + samplePeriod)))
+    {
+    }
+
+    void setYawReference(int32_t yaw) { yawReference = yaw; }
+    void reset() { yawReference = pitch = roll = yaw = 0; }
+
+    void update(const Vector3D<SampleType>& angularRate, const Vector3D<SampleType>& acceleration)
+    {
+        int32_t accelerationX = acceleration.X;
+        int32_t accelerationY = acceleration.Y;
+        int32_t accelerationZ = acceleration.Z;
+        // squares are summed as unsigned values, so 2 * 32768^2 does not overflow
+        auto squareX = static_cast<uint32_t>(accelerationX * accelerationX);
+        auto squareY = static_cast<uint32_t>(accelerationY * accelerationY);
+        auto squareZ = static_cast<uint32_t>(accelerationZ * accelerationZ);
+        auto accelerationXZ = static_cast<int32_t>(fixedSqrt(squareX + squareZ));
+        auto accelerationYZ = static_cast<int32_t>(fixedSqrt(squareY + squareZ));
+
+        // calculate pitch and roll from accelerometer itself
+        int32_t accelerometerPitch = fixedAtan2(accelerationY, accelerationXZ);
+        int32_t accelerometerRoll = fixedAtan2(accelerationX, accelerationYZ);
+
+        // integrate angular rate and correct with the reference angles
+        pitch = filter(pitch, angularRate.Y, accelerometerPitch);
+        roll = filter(roll, angularRate.X, accelerometerRoll);
+        yaw = filter(yaw, angularRate.Z, yawReference);
+    }
+
+    int32_t getPitch() const { return pitch; }
+    int32_t getRoll() const { return roll; }
+    int32_t getYaw() const { return yaw; }
+    void getYawSinCos(int16_t& sinYaw, int16_t& cosYaw) const
+    {
+        sinYaw = fixedSin(yaw);
+        cosYaw = fixedCos(yaw);
+    }
+private:
+    int32_t filter(int32_t angle, SampleType angularRate, int32_t referenceAngle) const
+    {
+        angle = addAngles(angle, static_cast<int32_t>((static_cast<int64_t>(angularRate) * rateGain) >> RateGainShift));     //NOLINT(hicpp-signed-bitwise)
+        return addAngles(angle, multiplyQ31(subtractAngles(referenceAngle, angle), filterFactor));
+    }
+    static constexpr int RateGainShift = 16;
+    static constexpr float RateGainScale = 65536.0F;    // 2^RateGainShift
+    int32_t rateGain;       // binary angle increment per raw angular rate unit per sample, scaled by 2^RateGainShift
+    int32_t filterFactor;   // Q31 complementary filter factor per sample
+    int32_t yawReference{0};
+    int32_t pitch{0};
+    int32_t roll{0};
+    int32_t yaw{0};
+};
+
+#endif /* FIXEDPOINT_H_ */
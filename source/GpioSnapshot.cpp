@@ -0,0 +1,30 @@
+#include "GpioSnapshot.h"
+
+/*
+configure the pin as input with the given mode and include its port in the snapshot
+*/
+void GpioSnapshot::addPin(PinName pin, PinMode mode)
+{
+    gpio_t gpio;
+    gpio_init_in_ex(&gpio, pin, mode);
+    size_t port = STM_PORT(pin);
+    if(inputRegisters[port] == nullptr)
+    {
+        // the input data register of the whole port
+        inputRegisters[port] = gpio.reg_in;
+        usedPorts[numberOfUsedPorts++] = static_cast<uint8_t>(port);
+    }
+    usedPinMasks[port] |= 1U << STM_PIN(pin);
+    levels[port] = *inputRegisters[port];
+}
+
+/*
+read the input data registers of all used ports
+*/
+void GpioSnapshot::capture()
+{
+    for(size_t index = 0; index < numberOfUsedPorts; index++)
+    {
+        levels[usedPorts[index]] = *inputRegisters[usedPorts[index]];
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef GPIOSNAPSHOT_H_
+#define GPIOSNAPSHOT_H_
+
+#include <mbed.h>
+#include <array>
+
+constexpr size_t NumberOfGpioPorts = 11;     // GPIO ports A..K
+using PortLevels = std::array<uint32_t, NumberOfGpioPorts>;     // input levels of all pins of every GPIO port
+
+// level of the pin in the port levels
+inline uint32_t getPinLevel(const PortLevels& levels, PinName pin) { return (levels[STM_PORT(pin)] >> STM_PIN(pin)) & 1U; }
+
+/*
+Snapshot of the GPIO input ports
+the input data register of every used port is read once per capture, so all pins are sampled at the same time
+and the level of any pin is then a shift and a mask of the captured value
+*/
+class GpioSnapshot
+{
+public:
+    void addPin(PinName pin, PinMode mode);
+    // configures the pins as inputs with the given mode
+    template<size_t NumberOfPins> void addPins(const std::array<PinName, NumberOfPins>& pins, PinMode mode)
+    {
+        for(auto pin : pins)
+        {
+            addPin(pin, mode);
+        }
+    }
+    void capture();
+    const PortLevels& getLevels() const { return levels; }
+    uint32_t getUsedPinMask(size_t port) const { return usedPinMasks[port]; }
+private:
+    std::array<volatile uint32_t*, NumberOfGpioPorts> inputRegisters{};    // input data registers of the used ports
+    std::array<uint8_t, NumberOfGpioPorts> usedPorts{};     // indexes (A=0) of the used ports
+    size_t numberOfUsedPorts{0};
+    PortLevels usedPinMasks{};      // pins added to the snapshot
+    PortLevels levels{};            // captured input levels of all ports
+};
+
+#endif /* GPIOSNAPSHOT_H_ */
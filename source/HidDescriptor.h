@@ -0,0 +1,300 @@
+#ifndef HIDDESCRIPTOR_H_
+#define HIDDESCRIPTOR_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// HID report descriptor short item prefixes (tag and type, without the data size)
+enum struct HidItem : uint8_t
+{
+    Input = 0x80,
+    Feature = 0xB0,
+    Collection = 0xA0,
+    EndCollection = 0xC0,
+    UsagePage = 0x04,
+    LogicalMinimum = 0x14,
+    LogicalMaximum = 0x24,
+    PhysicalMinimum = 0x34,
+    PhysicalMaximum = 0x44,
+    Unit = 0x64,
+    ReportSize = 0x74,
+    ReportId = 0x84,
+    ReportCount = 0x94,
+    Usage = 0x08,
+    UsageMinimum = 0x18,
+    UsageMaximum = 0x28
+};
+
+// data of the HID INPUT and FEATURE items
+constexpr uint8_t HidConstant = 0x03U;          // Cnst,Var,Abs
+constexpr uint8_t HidVariable = 0x02U;          // Data,Var,Abs
+constexpr uint8_t HidVariableNull = 0x42U;      // Data,Var,Abs,Null
+
+/*
+HID report field
+the fields of a report are listed in the order of the report bytes; a field with a usage page 0 is a constant padding
+the elements of a field with more than one element have consecutive usages starting from the field usage
+*/
+struct HidField     //NOLINT(altera-struct-pack-align)
+{
+    uint16_t usagePage;
+    uint8_t usage;              // usage or the usage minimum of the elements
+    uint8_t count;              // number of elements
+    uint8_t size;               // size of one element [bits]
+    int32_t logicalMinimum;
+    int32_t logicalMaximum;
+    int32_t physicalMinimum;    // physical range 0..0 means the logical range
+    int32_t physicalMaximum;
+    uint8_t unit;
+    uint8_t itemFlags;          // data of the INPUT or FEATURE item
+    bool isPointer;             // the field belongs to the physical pointer collection
+    size_t offset;              // byte offset of the field in the report structure
+};
+
+// fields of one report; the report ID 0 means a device with a single report without the report ID byte
+template<size_t NumberOfFields> struct HidReportFields
+{
+    uint8_t reportId;
+    HidItem mainItem;           // Input or Feature
+    std::array<HidField, NumberOfFields> fields;
+};
+
+// size of the report including the report ID [bits]
+template<size_t NumberOfFields> constexpr size_t getHidReportSize(const HidReportFields<NumberOfFields>& report)
+{
+    size_t bits = (report.reportId != 0) ? 8 : 0;       //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    for(size_t index = 0; index < NumberOfFields; index++)
+    {
+        bits += static_cast<size_t>(report.fields[index].size) * report.fields[index].count;
+    }
+    return bits;
+}
+
+// checks that every data field starts at the byte offset of its member in the report structure
+template<size_t NumberOfFields> constexpr bool isHidReportLayoutValid(const HidReportFields<NumberOfFields>& report)
+{
+    size_t bits = (report.reportId != 0) ? 8 : 0;       //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    for(size_t index = 0; index < NumberOfFields; index++)
+    {
+        const HidField& field = report.fields[index];
+        if((field.usagePage != 0) && (bits != field.offset * 8))    //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {
+            return false;
+        }
+        bits += static_cast<size_t>(field.size) * field.count;
+    }
+    return true;
+}
+
+/*
+HID report descriptor built at compile time
+items exceeding the capacity are counted but not stored, so the required capacity is the length of a descriptor
+built with any capacity
+*/
+template<size_t Capacity> struct HidDescriptor
+{
+    uint8_t data[Capacity];     //NOLINT(hicpp-avoid-c-arrays,modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+    size_t length;
+
+    constexpr void addByte(uint8_t byte)
+    {
+        if(length < Capacity)
+        {
+            data[length] = byte;
+        }
+        length++;
+    }
+
+    // item with unsigned data in 1 or 2 bytes
+    constexpr void addItem(HidItem item, uint32_t value)
+    {
+        constexpr uint32_t Max8bit = 0xFFU;
+        addByte(static_cast<uint8_t>(static_cast<uint8_t>(item) | (value > Max8bit ? 2U : 1U)));
+        addByte(static_cast<uint8_t>(value));
+        if(value > Max8bit)
+        {
+            addByte(static_cast<uint8_t>(value >> 8U));     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        }
+    }
+
+    // item with signed data in 1, 2 or 4 bytes
+    constexpr void addSignedItem(HidItem item, int32_t value)
+    {
+        constexpr int32_t Min8bit = -128;
+        constexpr int32_t Max8bit = 127;
+        constexpr int32_t Min16bit = -32768;
+        constexpr int32_t Max16bit = 32767;
+        auto data = static_cast<uint32_t>(value);
+        if((value >= Min8bit) && (value <= Max8bit))
+        {
+            addByte(static_cast<uint8_t>(static_cast<uint8_t>(item) | 1U));
+            addByte(static_cast<uint8_t>(data));
+        }
+        else if((value >= Min16bit) && (value <= Max16bit))
+        {
+            addByte(static_cast<uint8_t>(static_cast<uint8_t>(item) | 2U));
+            addByte(static_cast<uint8_t>(data));
+            addByte(static_cast<uint8_t>(data >> 8U));      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        }
+        else
+        {
+            addByte(static_cast<uint8_t>(static_cast<uint8_t>(item) | 3U));
+            for(uint32_t shift = 0; shift < 32; shift += 8)     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            {
+                addByte(static_cast<uint8_t>(data >> shift));
+            }
+        }
+    }
+
+    // global item added only if its value changes
+    constexpr void setGlobal(HidItem item, uint32_t& current, uint32_t value)
+    {
+        if(value != current)
+        {
+            addItem(item, value);
+            current = value;
+        }
+    }
+
+    constexpr void setSignedGlobal(HidItem item, int32_t& current, int32_t value)
+    {
+        if(value != current)
+        {
+            addSignedItem(item, value);
+            current = value;
+        }
+    }
+};
+
+// values of the global items in the descriptor being built
+struct HidGlobalState
+{
+    uint32_t usagePage{0};
+    int32_t logicalMinimum{INT32_MIN};      // not set yet
+    int32_t logicalMaximum{INT32_MIN};      // not set yet
+    int32_t physicalMinimum{INT32_MIN};     // not set yet
+    int32_t physicalMaximum{INT32_MIN};     // not set yet
+    uint32_t unit{0};
+    uint32_t size{0};
+    uint32_t count{0};
+};
+
+// the fields are reported with one main item
+constexpr bool isSameHidMainItem(const HidField& first, const HidField& next)
+{
+    return (next.count == 1) && (next.usagePage == first.usagePage) && (next.size == first.size) &&
+        (next.logicalMinimum == first.logicalMinimum) && (next.logicalMaximum == first.logicalMaximum) &&
+        (next.physicalMinimum == first.physicalMinimum) && (next.physicalMaximum == first.physicalMaximum) &&
+        (next.unit == first.unit) && (next.itemFlags == first.itemFlags) && (next.isPointer == first.isPointer);
+}
+
+/*
+add the main items of the report fields to the descriptor
+the consecutive single-element fields with the same global items are merged into one main item
+and the global items are added only when their values change
+*/
+template<size_t Capacity, size_t NumberOfFields>
+constexpr void addHidMainItems(HidDescriptor<Capacity>& descriptor, HidGlobalState& state, HidItem mainItem, const std::array<HidField, NumberOfFields>& fields)
+{
+    constexpr uint8_t GenericDesktopPage = 0x01U;
+    constexpr uint8_t PointerUsage = 0x01U;
+    constexpr uint8_t PhysicalCollection = 0x00U;
+    bool isPointer = false;
+    size_t index = 0;
+    while(index < NumberOfFields)
+    {
+        const HidField& field = fields[index];
+        if(field.isPointer != isPointer)
+        {
+            if(field.isPointer)
+            {
+                descriptor.setGlobal(HidItem::UsagePage, state.usagePage, GenericDesktopPage);
+                descriptor.addItem(HidItem::Usage, PointerUsage);
+                descriptor.addItem(HidItem::Collection, PhysicalCollection);
+            }
+            else
+            {
+                descriptor.addByte(static_cast<uint8_t>(HidItem::EndCollection));
+            }
+            isPointer = field.isPointer;
+        }
+
+        size_t groupEnd = index + 1;
+        if((field.count == 1) && (field.usagePage != 0))
+        {
+            while((groupEnd < NumberOfFields) && isSameHidMainItem(field, fields[groupEnd]))
+            {
+                groupEnd++;
+            }
+        }
+
+        if(field.usagePage != 0)
+        {
+            descriptor.setGlobal(HidItem::UsagePage, state.usagePage, field.usagePage);
+            descriptor.setSignedGlobal(HidItem::LogicalMinimum, state.logicalMinimum, field.logicalMinimum);
+            descriptor.setSignedGlobal(HidItem::LogicalMaximum, state.logicalMaximum, field.logicalMaximum);
+            descriptor.setSignedGlobal(HidItem::PhysicalMinimum, state.physicalMinimum, field.physicalMinimum);
+            descriptor.setSignedGlobal(HidItem::PhysicalMaximum, state.physicalMaximum, field.physicalMaximum);
+            descriptor.setGlobal(HidItem::Unit, state.unit, field.unit);
+        }
+        descriptor.setGlobal(HidItem::ReportSize, state.size, field.size);
+        descriptor.setGlobal(HidItem::ReportCount, state.count, (field.count == 1) ? static_cast<uint32_t>(groupEnd - index) : field.count);
+
+        if(field.usagePage != 0)
+        {
+            if(field.count == 1)
+            {
+                for(size_t usageIndex = index; usageIndex < groupEnd; usageIndex++)
+                {
+                    descriptor.addItem(HidItem::Usage, fields[usageIndex].usage);
+                }
+            }
+            else
+            {
+                descriptor.addItem(HidItem::UsageMinimum, field.usage);
+                descriptor.addItem(HidItem::UsageMaximum, static_cast<uint32_t>(field.usage) + field.count - 1);
+            }
+        }
+        descriptor.addItem(mainItem, field.itemFlags);
+        index = groupEnd;
+    }
+    if(isPointer)
+    {
+        descriptor.addByte(static_cast<uint8_t>(HidItem::EndCollection));
+    }
+}
+
+template<size_t Capacity> constexpr void addHidReports(HidDescriptor<Capacity>& /*descriptor*/, HidGlobalState& /*state*/) {}
+
+// add the items of the reports; the global items are kept from the previous report, as defined by the HID specification
+template<size_t Capacity, typename Report, typename... Reports>
+constexpr void addHidReports(HidDescriptor<Capacity>& descriptor, HidGlobalState& state, const Report& report, const Reports&... reports)
+{
+    if(report.reportId != 0)
+    {
+        descriptor.addItem(HidItem::ReportId, report.reportId);
+    }
+    addHidMainItems(descriptor, state, report.mainItem, report.fields);
+    addHidReports(descriptor, state, reports...);
+}
+
+/*
+build the report descriptor of an application collection with the reports
+*/
+template<size_t Capacity, typename... Reports>
+constexpr HidDescriptor<Capacity> makeHidDescriptor(uint8_t usagePage, uint8_t usage, const Reports&... reports)
+{
+    constexpr uint8_t ApplicationCollection = 0x01U;
+    HidDescriptor<Capacity> descriptor{};
+    HidGlobalState state{};
+    descriptor.addItem(HidItem::UsagePage, usagePage);
+    state.usagePage = usagePage;
+    descriptor.addItem(HidItem::Usage, usage);
+    descriptor.addItem(HidItem::Collection, ApplicationCollection);
+    addHidReports(descriptor, state, reports...);
+    descriptor.addByte(static_cast<uint8_t>(HidItem::EndCollection));
+    return descriptor;
+}
+
+#endif /* HIDDESCRIPTOR_H_ */
@@ -45,4 +45,17 @@ std::vector<uint8_t> I2CDevice::read(uint8_t registerAddress, uint8_t length)
         Alarm::getInstance().set(AlarmID::I2CReadAfterWrite);
     }
     return data;
+}
+
+/*
+ * start asynchronous read from I2C device
+ * the callback is called in interrupt context with the I2C event flags
+ * returns false if the transfer could not be started (e.g. bus busy)
+ * caution: the mbed I2C::transfer locks the bus mutex, so it must not be called from ISR
+ */
+bool I2CDevice::readAsync(uint8_t registerAddress, uint8_t* pData, uint16_t length, const event_callback_t& callback)
+{
+    asyncRegisterAddress = registerAddress;
+    return bus.transfer(static_cast<int>(address), reinterpret_cast<const char*>(&asyncRegisterAddress), 1,
+                        reinterpret_cast<char*>(pData), length, callback, I2C_EVENT_ALL) == 0;
 }
\ No newline at end of file
@@ -17,9 +17,12 @@ public:
     I2CDevice(I2C& bus, uint8_t deviceAddress);
     void write(uint8_t registerAddress, std::vector<uint8_t> data);
     std::vector<uint8_t> read(uint8_t registerAddress, uint8_t length);
+    bool readAsync(uint8_t registerAddress, uint8_t* pData, uint16_t length, const event_callback_t& callback);
+    void abortAsync() { bus.abort_transfer(); }      // must not be called from ISR
 private:
     I2C& bus;
     uint8_t address;
+    uint8_t asyncRegisterAddress{0};        // register address must stay valid during the asynchronous transfer
 };
 
 #endif /* I2CDEVICE_H_ */
\ No newline at end of file
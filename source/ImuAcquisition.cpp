@@ -0,0 +1,277 @@
+#include "ImuAcquisition.h"
+#include "Statistics.h"
+#include <algorithm>
+#include <iostream>
+
+ImuAcquisition::ImuAcquisition(Thread& thread, I2CDevice& sensorGA, I2CDevice& sensorM) :
+    thread(thread),
+    sensorGA(sensorGA),
+    sensorM(sensorM)
+{
+    Console::getInstance().registerCommand("is", "display IMU acquisition statistics", callback(this, &ImuAcquisition::displayStatistics));
+}
+
+/*
+start acquisition of a new frame
+to be called from IMU interrupt; the transfers are started from the acquisition thread
+*/
+void ImuAcquisition::start()
+{
+    if(core_util_atomic_exchange_bool(&isBusy, true))
+    {
+        // the previous frame is still being transferred
+        core_util_atomic_incr_u32(&framesSkipped, 1);
+        return;
+    }
+    acquiredFrame.interruptTime = getCycleCount();
+    thread.flags_set(StartFlag);
+}
+
+/*
+abort the frame in progress, whose transfer has been lost
+to be called from the acquisition timeout (ISR context); the bus transfer is aborted in the acquisition thread
+*/
+void ImuAcquisition::abort()
+{
+    thread.flags_set(AbortFlag);
+}
+
+/*
+execute the acquisition steps signalled with the thread flags
+to be called from the acquisition thread
+the transfer completions are handled before the abort, so a frame which has completed together with the timeout
+is published as valid; a start flag means that no frame was busy at the timeout, so the abort is dropped
+*/
+void ImuAcquisition::processFlags(uint32_t flags)
+{
+    if((flags & FifoStatusFlag) != 0)
+    {
+        processFifoStatus();
+    }
+    if((flags & GyroAccelFlag) != 0)
+    {
+        readMagnetometer();
+    }
+    if((flags & MagnetometerFlag) != 0)
+    {
+        processMagnetometer();
+        completeFrame();
+    }
+    if((flags & StartFlag) != 0)
+    {
+        readFifoStatus();
+    }
+    else if((flags & AbortFlag) != 0)
+    {
+        abortFrame();
+    }
+}
+
+/*
+abort the lost transfer of the frame in progress, publish the frame as invalid and restart the acquisition
+no new frame can be started while the lost one is busy, so the frame in progress is the lost one;
+a frame which has completed meanwhile is not aborted
+*/
+void ImuAcquisition::abortFrame()
+{
+    if(!isBusy)
+    {
+        return;
+    }
+    // both sensors are on the same bus, so this aborts the transfer of either sensor
+    sensorGA.abortAsync();
+    // drop the completion flags which could have been set just before the abort
+    ThisThread::flags_clear(TransferFlags);
+    core_util_atomic_store_u32(&transfersInFlight, 0);
+    core_util_atomic_incr_u32(&transfersFailed, 1);
+    framesAborted++;
+    acquiredFrame.isValid = false;
+    acquiredFrame.completionTime = getCycleCount();
+    completeFrame();
+    // re-issue the acquisition; reading an empty FIFO is harmless
+    start();
+}
+
+/*
+display transfer counters
+*/
+void ImuAcquisition::displayStatistics(CommandVector&  /*cv*/)
+{
+    std::cout << "I2C transfers done = " << transfersDone << std::endl;
+    std::cout << "I2C transfers in flight = " << transfersInFlight << std::endl;
+    std::cout << "I2C transfers failed = " << transfersFailed << std::endl;
+    std::cout << "IMU frames skipped = " << framesSkipped << std::endl;
+    std::cout << "IMU frames overwritten = " << framesOverwritten << std::endl;
+    std::cout << "IMU frames aborted = " << framesAborted << std::endl;
+    std::cout << "IMU FIFO samples read = " << samplesRead << std::endl;
+    std::cout << "IMU FIFO overruns = " << fifoOverruns << std::endl;
+    std::cout << "gyroscope/accelerometer fresh/stale frames = " << gyroAccelFresh << ", " << gyroAccelStale << std::endl;
+    std::cout << "magnetometer fresh/stale frames = " << magnetometerFresh << ", " << magnetometerStale << std::endl;
+    std::cout << "magnetometer overruns = " << magnetometerOverruns << std::endl;
+}
+
+/*
+start reading the FIFO status to get the number of unread samples
+*/
+void ImuAcquisition::readFifoStatus()
+{
+    acquiredFrame.isValid = true;
+    acquiredFrame.sampleCount = 0;
+    acquiredFrame.isFifoOverrun = false;
+    core_util_atomic_incr_u32(&transfersInFlight, 1);
+    if(!sensorGA.readAsync(static_cast<uint8_t>(LSM9DS1reg::FIFO_SRC), &fifoStatus, 1, callback(this, &ImuAcquisition::onFifoStatusTransfer)))
+    {
+        onFifoStatusTransfer(I2C_EVENT_ERROR);
+    }
+}
+
+/*
+start reading all unread gyroscope and accelerometer samples from FIFO in one burst
+the sensor continues with the next FIFO sample after the accelerometer output registers
+*/
+void ImuAcquisition::readGyroAccel()
+{
+    core_util_atomic_incr_u32(&transfersInFlight, 1);
+    if(!sensorGA.readAsync(static_cast<uint8_t>(LSM9DS1reg::OUT_X_L_G), acquiredFrame.gyroAccelData.data(),
+                           acquiredFrame.sampleCount * ImuFrame::SampleDataSize, callback(this, &ImuAcquisition::onGyroAccelTransfer)))
+    {
+        // transfer not started - continue with the magnetometer
+        onGyroAccelTransfer(I2C_EVENT_ERROR);
+    }
+}
+
+/*
+start reading the magnetometer status and data
+the status register precedes the output registers, so both are read in one burst;
+a separate status read would cost more bus time than the stale data reads it could skip
+*/
+void ImuAcquisition::readMagnetometer()
+{
+    core_util_atomic_incr_u32(&transfersInFlight, 1);
+    if(!sensorM.readAsync(static_cast<uint8_t>(LSM9DS1reg::STATUS_REG_M), magnetometerBuffer.data(),
+                          magnetometerBuffer.size(), callback(this, &ImuAcquisition::onMagnetometerTransfer)))
+    {
+        onMagnetometerTransfer(I2C_EVENT_ERROR);
+    }
+}
+
+/*
+FIFO status transfer completion callback (ISR context)
+*/
+void ImuAcquisition::onFifoStatusTransfer(int event)
+{
+    onTransferEvent(event);
+    thread.flags_set(FifoStatusFlag);
+}
+
+/*
+evaluate the FIFO status and continue with the FIFO samples or with the magnetometer
+*/
+void ImuAcquisition::processFifoStatus()
+{
+    constexpr uint8_t FifoOverrunMask = 0x40U;
+    constexpr uint8_t FifoSamplesMask = 0x3FU;
+    if(acquiredFrame.isValid)
+    {
+        acquiredFrame.isFifoOverrun = (fifoStatus & FifoOverrunMask) != 0;
+        acquiredFrame.sampleCount = std::min<uint8_t>(fifoStatus & FifoSamplesMask, ImuFrame::MaxFifoSamples);
+    }
+    if(acquiredFrame.isFifoOverrun)
+    {
+        fifoOverruns++;
+    }
+    if(acquiredFrame.sampleCount != 0)
+    {
+        gyroAccelFresh++;
+        samplesRead += acquiredFrame.sampleCount;
+        readGyroAccel();
+    }
+    else
+    {
+        // FIFO is empty - read the magnetometer only
+        gyroAccelStale++;
+        readMagnetometer();
+    }
+}
+
+/*
+gyroscope and accelerometer transfer completion callback (ISR context)
+*/
+void ImuAcquisition::onGyroAccelTransfer(int event)
+{
+    onTransferEvent(event);
+    thread.flags_set(GyroAccelFlag);
+}
+
+/*
+magnetometer transfer completion callback (ISR context)
+*/
+void ImuAcquisition::onMagnetometerTransfer(int event)
+{
+    acquiredFrame.completionTime = getCycleCount();
+    onTransferEvent(event);
+    thread.flags_set(MagnetometerFlag);
+}
+
+/*
+evaluate the magnetometer status and take the magnetometer data if it is a new sample
+*/
+void ImuAcquisition::processMagnetometer()
+{
+    constexpr uint8_t NewDataMask = 0x08U;      // ZYXDA
+    constexpr uint8_t OverrunMask = 0x80U;      // ZYXOR
+    uint8_t status = magnetometerBuffer[0];
+    acquiredFrame.isMagnetometerFresh = acquiredFrame.isValid && ((status & NewDataMask) != 0);
+    if(acquiredFrame.isMagnetometerFresh)
+    {
+        magnetometerFresh++;
+        std::copy(magnetometerBuffer.begin() + 1, magnetometerBuffer.end(), acquiredFrame.magnetometerData.begin());
+        if((status & OverrunMask) != 0)
+        {
+            magnetometerOverruns++;
+        }
+    }
+    else
+    {
+        magnetometerStale++;
+    }
+}
+
+/*
+update transfer counters on a transfer event
+*/
+void ImuAcquisition::onTransferEvent(int event)
+{
+    core_util_atomic_decr_u32(&transfersInFlight, 1);
+    if((static_cast<uint32_t>(event) & I2C_EVENT_TRANSFER_COMPLETE) != 0)
+    {
+        core_util_atomic_incr_u32(&transfersDone, 1);
+    }
+    else
+    {
+        core_util_atomic_incr_u32(&transfersFailed, 1);
+        acquiredFrame.isValid = false;
+    }
+}
+
+/*
+publish the acquired frame and notify the frame consumer
+*/
+void ImuAcquisition::completeFrame()
+{
+    {
+        CriticalSectionLock lock;
+        if(isFrameReady)
+        {
+            // the previous frame has not been read yet
+            framesOverwritten++;
+        }
+        completedFrame = acquiredFrame;
+        isFrameReady = true;
+    }
+    core_util_atomic_store_bool(&isBusy, false);
+    if(frameReadyCb)
+    {
+        frameReadyCb();
+    }
+}
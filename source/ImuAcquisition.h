@@ -0,0 +1,116 @@
+#ifndef IMUACQUISITION_H_
+#define IMUACQUISITION_H_
+
+#include "Console.h"
+#include "I2CDevice.h"
+#include <mbed.h>
+#include <array>
+
+enum struct LSM6DS3reg : uint8_t
+{
+    INT1_CTRL = 0x0D,
+    CTRL1_XL = 0x10,
+    CTRL7_G = 0x16,
+    OUT_X_L_G = 0x22,
+};
+
+enum struct LSM9DS1reg : uint8_t
+{
+    INT1_CTRL = 0x0C,
+    CTRL_REG1_G = 0x10,
+    OUT_X_L_G = 0x18,
+    CTRL_REG6_XL = 0x20,
+    CTRL_REG9 = 0x23,
+    FIFO_CTRL = 0x2E,
+    FIFO_SRC = 0x2F,
+    CTRL_REG1_M = 0x20,
+    STATUS_REG_M = 0x27,
+    OUT_X_L_M = 0x28
+};
+
+/*
+raw register data of one IMU frame
+the frame contains all gyroscope/accelerometer samples drained from the sensor FIFO
+*/
+struct ImuFrame     //NOLINT(altera-struct-pack-align)
+{
+    static constexpr size_t MaxFifoSamples = 32;
+    static constexpr size_t SampleDataSize = 12;
+    static constexpr size_t MagnetometerDataSize = 6;
+    std::array<uint8_t, MaxFifoSamples * SampleDataSize> gyroAccelData;    // gyroscope and accelerometer output registers of consecutive FIFO samples
+    std::array<uint8_t, MagnetometerDataSize> magnetometerData;     // magnetometer output registers
+    uint8_t sampleCount;    // number of gyroscope/accelerometer samples in this frame
+    bool isFifoOverrun;     // FIFO samples have been lost before this frame
+    bool isValid;           // false if any transfer of this frame has failed
+    bool isMagnetometerFresh;   // the magnetometer data is a new sample since the previous frame
+    uint32_t interruptTime;     // cycle counter value at the IMU interrupt which started this frame
+    uint32_t completionTime;    // cycle counter value at the completion of the last transfer of this frame
+    const uint8_t* getSample(size_t index) const { return &gyroAccelData[index * SampleDataSize]; }
+};
+
+/*
+Non-blocking acquisition of the IMU sensor data
+the FIFO status, FIFO samples and magnetometer reads are chained with I2C transfer completion callbacks;
+the interrupt and the callbacks wake the acquisition thread with thread flags, which starts the next transfer,
+so no event memory is allocated and the thread does not wait for the bus transfers
+each sensor is processed at its own data rate: the gyroscope/accelerometer samples are gated by the FIFO level
+and the magnetometer data by its status register, which is read in the same burst as the output registers
+*/
+class ImuAcquisition
+{
+public:
+    static constexpr uint32_t StartFlag = 0x01U;            // IMU interrupt - start a new frame
+    static constexpr uint32_t FifoStatusFlag = 0x02U;       // FIFO status transfer completed
+    static constexpr uint32_t GyroAccelFlag = 0x04U;        // gyroscope and accelerometer transfer completed
+    static constexpr uint32_t MagnetometerFlag = 0x08U;     // magnetometer transfer completed
+    static constexpr uint32_t AbortFlag = 0x10U;            // the frame transfer has not completed in time
+    static constexpr uint32_t TransferFlags = FifoStatusFlag | GyroAccelFlag | MagnetometerFlag;
+    static constexpr uint32_t AllFlags = StartFlag | TransferFlags | AbortFlag;
+    ImuAcquisition(Thread& thread, I2CDevice& sensorGA, I2CDevice& sensorM);
+    void setCallback(Callback<void()> cb) { frameReadyCb = cb; }     // called in the acquisition thread when a new frame is complete
+    void start();
+    void abort();
+    bool isAcquiring() const { return isBusy; }
+    void processFlags(uint32_t flags);
+    bool getFrame(ImuFrame& frame);
+    void displayStatistics(CommandVector& cv);
+    uint32_t getFramesSkipped() const { return framesSkipped; }
+    uint32_t getFramesOverwritten() const { return framesOverwritten; }
+private:
+    void readFifoStatus();
+    void readGyroAccel();
+    void readMagnetometer();
+    void onFifoStatusTransfer(int event);
+    void onGyroAccelTransfer(int event);
+    void onMagnetometerTransfer(int event);
+    void onTransferEvent(int event);
+    void processFifoStatus();
+    void processMagnetometer();
+    void completeFrame();
+    void abortFrame();
+    Thread& thread;                     // acquisition thread which starts the transfers
+    I2CDevice& sensorGA;                // IMU gyroscope and accelerometer sensor
+    I2CDevice& sensorM;                 // magnetometer sensor
+    Callback<void()> frameReadyCb{nullptr};
+    ImuFrame acquiredFrame{};           // frame being currently transferred
+    ImuFrame completedFrame{};          // the last complete frame
+    uint8_t fifoStatus{0};              // FIFO_SRC register value
+    std::array<uint8_t, 1 + ImuFrame::MagnetometerDataSize> magnetometerBuffer{};  // STATUS_REG_M and magnetometer output registers
+    volatile bool isBusy{false};        // frame acquisition in progress
+    volatile bool isFrameReady{false};  // new frame available for reading
+    volatile uint32_t transfersDone{0};
+    volatile uint32_t transfersInFlight{0};
+    volatile uint32_t transfersFailed{0};
+    volatile uint32_t framesSkipped{0}; // acquisition requests while the previous frame was still in progress
+    volatile uint32_t framesOverwritten{0}; // completed frames overwritten before being read by the consumer
+    uint32_t framesAborted{0};          // frames with a lost transfer aborted after the acquisition timeout
+    volatile uint32_t samplesRead{0};   // gyroscope/accelerometer samples read from FIFO
+    volatile uint32_t fifoOverruns{0};  // frames preceded by FIFO overrun
+    uint32_t gyroAccelFresh{0};         // frames with new gyroscope/accelerometer samples
+    uint32_t gyroAccelStale{0};         // frames with empty FIFO
+    uint32_t magnetometerFresh{0};      // frames with a new magnetometer sample
+    uint32_t magnetometerStale{0};      // frames without a new magnetometer sample
+    uint32_t magnetometerOverruns{0};   // magnetometer samples overwritten before being read
+};
+
+#endif /* IMUACQUISITION_H_ */
@@ -5,7 +5,7 @@
 Menu::Menu() :
     menuQueueDispatchThread(osPriority_t::osPriorityLow4, OS_STACK_SIZE, nullptr, "menu"),
     execPushbutton(SwitchType::Pushbutton, PF_3, eventQueue),
-    menuSelector(SwitchType::RotaryEncoder, PE_0, eventQueue, 0.01F, PF_11)     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    menuSelector(PE_0, PF_11, eventQueue)
 {
     // Start the display queue's dispatch thread
     menuQueueDispatchThread.start(callback(&eventQueue, &EventQueue::dispatch_forever));
@@ -35,14 +35,14 @@ void Menu::execute(uint8_t  /*argument*/)
 
 /*
 change active menu item
-direction 0 (left) or 1 (right)
+steps: number of items to move by, negative to the left
 */
-void Menu::changeItem(uint8_t direction)
+void Menu::changeItem(int steps)
 {
     if(isChangeItemEnabled && !menuItems.empty())
     {
-        uint8_t noOfItems = menuItems.size();
-        currentItem = (currentItem + direction * 2 - 1 + noOfItems) % noOfItems;
+        int noOfItems = static_cast<int>(menuItems.size());
+        currentItem = static_cast<uint8_t>(((currentItem + steps) % noOfItems + noOfItems) % noOfItems);
         displayItemText();
     }
 }
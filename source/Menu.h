@@ -2,6 +2,7 @@
 #define MENU_H_
 
 #include "Switch.h"
+#include "RotaryEncoder.h"
 #include "Display.h"
 #include <mbed.h>
 #include <string>
@@ -26,15 +27,16 @@ public:
     void enableDisplay() { displayEnabled = true; }
     void disableDisplay() { displayEnabled = false; }
     bool isDisplayEnabled() const { return displayEnabled; }
+    void defer(Callback<void(void)> function) { eventQueue.call(function); }    // calls the function in the low priority menu thread
 private:
     Menu(); // private constructor definition
     ~Menu() = default;
     void execute(uint8_t argument);
-    void changeItem(uint8_t direction);
+    void changeItem(int steps);
     EventQueue eventQueue;
     Thread menuQueueDispatchThread;
     Switch execPushbutton;
-    Switch menuSelector;
+    RotaryEncoder menuSelector;
     std::vector<MenuItem> menuItems;
     uint8_t currentItem{0};
     const uint8_t MessageLine = 35;
@@ -0,0 +1,179 @@
+#include "Orientation.h"
+
+/*
+update orientation with a new gyroscope and accelerometer sample
+angularRate [rad/s], acceleration [g], deltaT [s]
+*/
+void ComplementaryFilter::update(const Vector3D<float>& angularRate, const Vector3D<float>& acceleration, float deltaT)
+{
+    float accelerationXZ = fastSqrt(acceleration.X * acceleration.X + acceleration.Z * acceleration.Z);
+    float accelerationYZ = fastSqrt(acceleration.Y * acceleration.Y + acceleration.Z * acceleration.Z);
+
+    // calculate pitch and roll from accelerometer itself [rad]
+    float accelerometerPitch = fastAtan2(acceleration.Y, accelerationXZ);
+    float accelerometerRoll = fastAtan2(acceleration.X, accelerationYZ);
+
+    // calculate sensor pitch, roll and yaw using complementary filter [rad]
+    float filterFactor = deltaT / (timeConstant + deltaT);
+    pitch = (1.0F - filterFactor) * (pitch + angularRate.Y * deltaT) + filterFactor * accelerometerPitch;
+    roll = (1.0F - filterFactor) * (roll + angularRate.X * deltaT) + filterFactor * accelerometerRoll;
+    yaw = (1.0F - filterFactor) * (yaw + angularRate.Z * deltaT) + filterFactor * yawReference;
+}
+
+void ComplementaryFilter::getYawSinCos(float& sinYaw, float& cosYaw) const
+{
+    sinYaw = fastSin(yaw);
+    cosYaw = fastCos(yaw);
+}
+
+MahonyFilter::MahonyFilter(float timeConstant, float integralGain) :
+    proportionalGain(1.0F / timeConstant),
+    integralGain(integralGain)
+{
+}
+
+/*
+set the yaw reference direction
+called once per frame, so the trigonometric functions are not evaluated for every sample
+*/
+void MahonyFilter::setYawReference(float yaw)
+{
+    sinYawReference = fastSin(yaw);
+    cosYawReference = fastCos(yaw);
+}
+
+/*
+return to the initial orientation and clear the integral error
+*/
+void MahonyFilter::reset()
+{
+    sinYawReference = 0.0F;
+    cosYawReference = 1.0F;
+    q0 = 1.0F;
+    q1 = q2 = q3 = 0.0F;
+    integralError = {0.0F, 0.0F, 0.0F};
+}
+
+/*
+update orientation quaternion with a new gyroscope and accelerometer sample
+angularRate [rad/s], acceleration [g], deltaT [s]
+*/
+void MahonyFilter::update(const Vector3D<float>& angularRate, const Vector3D<float>& acceleration, float deltaT)
+{
+    // the accelerometer vector expressed in the filter frame; it points to +Z at rest
+    float ax = -acceleration.Y;
+    float ay = acceleration.X;
+    float az = acceleration.Z;
+    float gx = angularRate.X;
+    float gy = angularRate.Y;
+    float gz = angularRate.Z;
+
+    // half of the estimated vertical direction in the sensor frame
+    float halfVx = q1 * q3 - q0 * q2;
+    float halfVy = q0 * q1 + q2 * q3;
+    float halfVz = q0 * q0 - 0.5F + q3 * q3;     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    float halfEx{0.0F};
+    float halfEy{0.0F};
+    float halfEz{0.0F};
+
+    float accelerationNorm = ax * ax + ay * ay + az * az;
+    if(accelerationNorm > 0.0F)
+    {
+        // error is the cross product between the measured and the estimated vertical direction
+        float recipNorm = fastInvSqrt(accelerationNorm);
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+        halfEx = ay * halfVz - az * halfVy;
+        halfEy = az * halfVx - ax * halfVz;
+        halfEz = ax * halfVy - ay * halfVx;
+    }
+
+    // estimated heading direction in the horizontal plane (unnormalized cos and sin of yaw)
+    float headingX = 0.5F - q2 * q2 - q3 * q3;      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    float headingY = q0 * q3 + q1 * q2;
+    float headingNorm = headingX * headingX + headingY * headingY;
+    if(headingNorm > 0.0F)
+    {
+        // yaw error sin(reference - yaw) acts around the vertical axis
+        float recipNorm = fastInvSqrt(headingNorm);
+        float yawError = (sinYawReference * headingX - cosYawReference * headingY) * recipNorm;
+        halfEx += halfVx * yawError;
+        halfEy += halfVy * yawError;
+        halfEz += halfVz * yawError;
+    }
+
+    if(integralGain > 0.0F)
+    {
+        integralError.X += 2.0F * integralGain * halfEx * deltaT;
+        integralError.Y += 2.0F * integralGain * halfEy * deltaT;
+        integralError.Z += 2.0F * integralGain * halfEz * deltaT;
+        gx += integralError.X;
+        gy += integralError.Y;
+        gz += integralError.Z;
+    }
+
+    // proportional feedback
+    gx += 2.0F * proportionalGain * halfEx;
+    gy += 2.0F * proportionalGain * halfEy;
+    gz += 2.0F * proportionalGain * halfEz;
+
+    // integrate rate of change of quaternion
+    gx *= 0.5F * deltaT;        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    gy *= 0.5F * deltaT;        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    gz *= 0.5F * deltaT;        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    float qa = q0;
+    float qb = q1;
+    float qc = q2;
+    q0 += -qb * gx - qc * gy - q3 * gz;
+    q1 += qa * gx + qc * gz - q3 * gy;
+    q2 += qa * gy - qb * gz + q3 * gx;
+    q3 += qa * gz + qb * gy - qc * gx;
+
+    // normalise quaternion
+    float recipNorm = fastInvSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q0 *= recipNorm;
+    q1 *= recipNorm;
+    q2 *= recipNorm;
+    q3 *= recipNorm;
+}
+
+// pitch angle [rad]
+float MahonyFilter::getPitch() const
+{
+    return fastAsin(limit(2.0F * (q0 * q2 - q1 * q3), -1.0F, 1.0F));
+}
+
+// roll angle [rad]
+float MahonyFilter::getRoll() const
+{
+    return fastAtan2(q0 * q1 + q2 * q3, 0.5F - q1 * q1 - q2 * q2);     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+}
+
+// yaw angle [rad]
+float MahonyFilter::getYaw() const
+{
+    return fastAtan2(q0 * q3 + q1 * q2, 0.5F - q2 * q2 - q3 * q3);     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+}
+
+/*
+sin and cos of the yaw angle calculated directly from the quaternion
+*/
+void MahonyFilter::getYawSinCos(float& sinYaw, float& cosYaw) const
+{
+    float headingX = 0.5F - q2 * q2 - q3 * q3;      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    float headingY = q0 * q3 + q1 * q2;
+    float headingNorm = headingX * headingX + headingY * headingY;
+    if(headingNorm > 0.0F)
+    {
+        float recipNorm = fastInvSqrt(headingNorm);
+        sinYaw = headingY * recipNorm;
+        cosYaw = headingX * recipNorm;
+    }
+    else
+    {
+        sinYaw = 0.0F;
+        cosYaw = 1.0F;
+    }
+}
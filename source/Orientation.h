@@ -0,0 +1,64 @@
+#ifndef ORIENTATION_H_
+#define ORIENTATION_H_
+
+#include "Convert.h"
+
+/*
+Orientation engines of the IMU sensor
+both engines share the same interface, so the yoke handler can use either of them:
+setYawReference() - once per IMU frame, yaw measured by the magnetometer [rad]
+update() - for every gyroscope/accelerometer sample
+getPitch(), getRoll(), getYaw(), getYawSinCos() - once per IMU frame
+reset() - return to the initial orientation
+body axes: X = roll axis, Y = pitch axis, Z = yaw axis (pointing down)
+*/
+
+/*
+Euler angles complementary filter
+pitch, roll and yaw are filtered separately
+*/
+class ComplementaryFilter
+{
+public:
+    explicit ComplementaryFilter(float timeConstant) : timeConstant(timeConstant) {}
+    void setYawReference(float yaw) { yawReference = yaw; }
+    void update(const Vector3D<float>& angularRate, const Vector3D<float>& acceleration, float deltaT);
+    void reset() { yawReference = pitch = roll = yaw = 0.0F; }
+    float getPitch() const { return pitch; }
+    float getRoll() const { return roll; }
+    float getYaw() const { return yaw; }
+    void getYawSinCos(float& sinYaw, float& cosYaw) const;
+private:
+    float timeConstant;         // time constant of the gyroscope drift correction [s]
+    float yawReference{0.0F};   // yaw measured by the magnetometer [rad]
+    float pitch{0.0F};
+    float roll{0.0F};
+    float yaw{0.0F};
+};
+
+/*
+Mahony quaternion filter
+the gyroscope rate is corrected with the error between the measured and the estimated gravity and yaw reference directions
+one update costs a fixed number of multiplications and a single reciprocal square root per vector, no trigonometric functions
+*/
+class MahonyFilter
+{
+public:
+    explicit MahonyFilter(float timeConstant, float integralGain = 0.0F);
+    void setYawReference(float yaw);
+    void update(const Vector3D<float>& angularRate, const Vector3D<float>& acceleration, float deltaT);
+    void reset();
+    float getPitch() const;
+    float getRoll() const;
+    float getYaw() const;
+    void getYawSinCos(float& sinYaw, float& cosYaw) const;
+private:
+    float proportionalGain;         // [1/s]
+    float integralGain;             // [1/s^2]
+    float sinYawReference{0.0F};    // sin of the yaw measured by the magnetometer
+    float cosYawReference{1.0F};    // cos of the yaw measured by the magnetometer
+    float q0{1.0F}, q1{0.0F}, q2{0.0F}, q3{0.0F};      // orientation quaternion
+    Vector3D<float> integralError{0.0F, 0.0F, 0.0F};
+};
+
+#endif /* ORIENTATION_H_ */
@@ -0,0 +1,75 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+/*
+add a stage duration to the statistics
+*/
+void StageStatistics::add(uint32_t cycles)
+{
+    count++;
+    sum += cycles;
+    minimum = std::min(minimum, cycles);
+    maximum = std::max(maximum, cycles);
+    // bucket index is the position of the most significant bit
+    size_t bucket = (cycles == 0) ? 0 : static_cast<size_t>(31 - __builtin_clz(cycles));      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    histogram[std::min(bucket, NumberOfBuckets - 1)]++;
+}
+
+void StageStatistics::reset()
+{
+    *this = StageStatistics();
+}
+
+/*
+display stage statistics and the non-empty histogram buckets
+*/
+void StageStatistics::display(const char* name) const
+{
+    std::cout << name << ": count=" << std::dec << count;
+    if(count == 0)
+    {
+        std::cout << std::endl;
+        return;
+    }
+    std::cout << " min=" << minimum << " max=" << maximum << " mean=" << static_cast<uint32_t>(sum / count) << " [cycles]" << std::endl;
+    for(size_t bucket = 0; bucket < NumberOfBuckets; bucket++)
+    {
+        if(histogram[bucket] != 0)
+        {
+            std::cout << "  >=" << std::setw(8) << (1UL << bucket) << ": " << histogram[bucket] << std::endl;
+        }
+    }
+}
+
+/*
+add latency of one report
+interruptTime - IMU interrupt, completionTime - IMU frame transfers completed,
+dispatchTime - handler started, reportTime - USB report sent
+*/
+void LatencyMonitor::add(uint32_t interruptTime, uint32_t completionTime, uint32_t dispatchTime, uint32_t reportTime)
+{
+    uint32_t currentLatency = reportTime - interruptTime;
+    latency.add(currentLatency);
+    wakeUpDelay.add(dispatchTime - completionTime);
+    if(isPreviousLatencyValid)
+    {
+        jitter.add((currentLatency > previousLatency) ? (currentLatency - previousLatency) : (previousLatency - currentLatency));
+    }
+    previousLatency = currentLatency;
+    isPreviousLatencyValid = true;
+}
+
+void LatencyMonitor::reset()
+{
+    *this = LatencyMonitor();
+}
+
+void LatencyMonitor::display() const
+{
+    latency.display("IMU interrupt to USB report latency");
+    wakeUpDelay.display("thread wake-up delay");
+    jitter.display("latency jitter");
+    std::cout << "frames missed = " << framesMissed << std::endl;
+}
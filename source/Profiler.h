@@ -0,0 +1,105 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "Statistics.h"
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/*
+execution time statistics of one code stage in CPU clock cycles
+the histogram has logarithmic buckets: bucket n counts durations in the range <2^n, 2^(n+1))
+*/
+class StageStatistics
+{
+public:
+    void add(uint32_t cycles);
+    void reset();
+    void display(const char* name) const;
+private:
+    static constexpr size_t NumberOfBuckets = 24;       // the last bucket collects all durations from 2^23 cycles
+    uint32_t count{0};
+    uint32_t minimum{std::numeric_limits<uint32_t>::max()};
+    uint32_t maximum{0};
+    uint64_t sum{0};
+    std::array<uint32_t, NumberOfBuckets> histogram{};
+};
+
+/*
+cycle profiler of the consecutive stages of a periodic handler
+start() marks the beginning of the handler, mark(stage) closes the stage which started at the previous mark
+all storage is allocated statically in the object
+*/
+template<typename Stage, size_t NumberOfStages> class CycleProfiler
+{
+public:
+    explicit CycleProfiler(const std::array<const char*, NumberOfStages>& stageNames) : stageNames(stageNames)
+    {
+        enableCycleCounter();
+    }
+    void start()
+    {
+        startTime = stageStartTime = getCycleCount();
+    }
+    uint32_t getStartTime() const { return startTime; }
+    void mark(Stage stage)
+    {
+        uint32_t now = getCycleCount();
+        stages[static_cast<size_t>(stage)].add(now - stageStartTime);
+        stageStartTime = now;
+    }
+    // add a stage duration measured outside of the handler
+    void add(Stage stage, uint32_t cycles)
+    {
+        stages[static_cast<size_t>(stage)].add(cycles);
+    }
+    void stop()
+    {
+        total.add(getCycleCount() - startTime);
+    }
+    void display() const
+    {
+        for(size_t stage = 0; stage < NumberOfStages; stage++)
+        {
+            stages[stage].display(stageNames[stage]);
+        }
+        total.display("handler total");
+    }
+    void reset()
+    {
+        for(auto& stage : stages)
+        {
+            stage.reset();
+        }
+        total.reset();
+    }
+private:
+    const std::array<const char*, NumberOfStages> stageNames;
+    std::array<StageStatistics, NumberOfStages> stages{};
+    StageStatistics total;          // statistics of the whole handler from start() to stop()
+    uint32_t startTime{0};          // cycle counter value at handler start
+    uint32_t stageStartTime{0};     // cycle counter value at the beginning of the current stage
+};
+
+/*
+end-to-end latency of the IMU data in CPU clock cycles
+measured from the IMU interrupt to the return from the USB report sending
+jitter is the latency difference between consecutive reports
+*/
+class LatencyMonitor
+{
+public:
+    void add(uint32_t interruptTime, uint32_t completionTime, uint32_t dispatchTime, uint32_t reportTime);
+    void addMissed() { framesMissed++; }
+    void reset();
+    void display() const;
+private:
+    StageStatistics latency;        // IMU interrupt -> USB report sent
+    StageStatistics wakeUpDelay;    // last IMU frame transfer complete -> handler started in the acquisition thread
+    StageStatistics jitter;         // absolute latency change between consecutive reports
+    uint32_t previousLatency{0};
+    bool isPreviousLatencyValid{false};
+    uint32_t framesMissed{0};       // handler calls without a new IMU frame
+};
+
+#endif /* PROFILER_H_ */
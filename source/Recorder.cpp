@@ -0,0 +1,222 @@
+#include "Recorder.h"
+#include "CdcStream.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// ring buffer of the recorded data; statically allocated, as it does not fit in any thread stack
+constexpr size_t RecorderCapacity = MBED_CONF_APP_RECORDER_CAPACITY;
+static std::array<SensorRecord, RecorderCapacity> recordBuffer;     //NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+Recorder::Recorder()
+{
+    Console::getInstance().registerCommand("rs", "start sensor recording", callback(this, &Recorder::startRecording));
+    Console::getInstance().registerCommand("rt", "stop sensor recording or replay", callback(this, &Recorder::stop));
+    Console::getInstance().registerCommand("rd", "dump recorded sensor data as a binary stream", callback(this, &Recorder::dump));
+    Console::getInstance().registerCommand("rp", "replay recorded sensor data through the yoke handler", callback(this, &Recorder::startReplay));
+    Console::getInstance().registerCommand("rl", "stream live sensor data over the USB serial port", callback(this, &Recorder::startStreaming));
+}
+
+/*
+* store the IMU frame and the yoke inputs in the ring buffer
+*/
+void Recorder::record(const ImuFrame& frame, const YokeInputs& inputs)
+{
+    if(state == RecorderState::Streaming)
+    {
+        streamRecord(frame, inputs);
+        return;
+    }
+
+    size_t index{0};
+    {
+        CriticalSectionLock lock;
+        if(state != RecorderState::Recording)
+        {
+            return;
+        }
+        index = writeIndex;
+        writeIndex = (writeIndex + 1) % RecorderCapacity;
+        recordCount = std::min(recordCount + 1, RecorderCapacity);
+    }
+    // the console reads the buffer only after leaving the recording state, which cannot preempt the IMU thread here
+    fillRecord(recordBuffer[index], frame, inputs);
+}
+
+/*
+* copy the IMU frame and the yoke inputs to the record
+*/
+void Recorder::fillRecord(SensorRecord& record, const ImuFrame& frame, const YokeInputs& inputs)
+{
+    record.interruptTime = frame.interruptTime;
+    record.inputs = inputs;
+    if(frame.sampleCount > SensorRecord::MaxSamples)
+    {
+        framesTruncated++;
+    }
+    record.sampleCount = std::min<uint8_t>(frame.sampleCount, SensorRecord::MaxSamples);
+    record.isValid = frame.isValid ? 1 : 0;
+    record.isMagnetometerFresh = frame.isMagnetometerFresh ? 1 : 0;
+    std::memcpy(record.gyroAccelData.data(), frame.gyroAccelData.data(), record.sampleCount * ImuFrame::SampleDataSize);
+    record.magnetometerData = frame.magnetometerData;
+}
+
+/*
+* send the record of the IMU frame and the yoke inputs in the telemetry stream
+* the IMU thread never waits for the USB transfers; a packet that does not fit in the transmit buffer is dropped
+*/
+void Recorder::streamRecord(const ImuFrame& frame, const YokeInputs& inputs)
+{
+    TelemetryPacket packet{{'Y', 'T', 'L', 'M'}, sizeof(SensorRecord), streamSequence++, {}, 0};
+    fillRecord(packet.record, frame, inputs);
+    packet.checksum = getTelemetryChecksum(packet);
+    if(CdcStream::getInstance().writeNonBlocking(&packet, sizeof(packet)))
+    {
+        recordsStreamed++;
+    }
+    else
+    {
+        recordsDropped++;
+    }
+}
+
+/*
+* replace the IMU frame data and the yoke inputs with the next recorded values
+* the time stamps of the live frame are kept
+* the replay callback is called before the first record
+* returns false if the replay is not active
+*/
+bool Recorder::replay(ImuFrame& frame, YokeInputs& inputs)
+{
+    size_t index{0};
+    bool isFirstRecord{false};
+    {
+        CriticalSectionLock lock;
+        if(state != RecorderState::Replaying)
+        {
+            return false;
+        }
+        // the oldest record is replayed first
+        index = (writeIndex + RecorderCapacity - recordCount + replayCount) % RecorderCapacity;
+        isFirstRecord = (replayCount == 0);
+        if(++replayCount >= recordCount)
+        {
+            state = RecorderState::Idle;
+        }
+    }
+    if(isFirstRecord && replayCb)
+    {
+        replayCb();
+    }
+
+    const SensorRecord& record = recordBuffer[index];
+    inputs = record.inputs;
+    frame.sampleCount = record.sampleCount;
+    frame.isValid = record.isValid != 0;
+    frame.isMagnetometerFresh = record.isMagnetometerFresh != 0;
+    std::memcpy(frame.gyroAccelData.data(), record.gyroAccelData.data(), record.sampleCount * ImuFrame::SampleDataSize);
+    frame.magnetometerData = record.magnetometerData;
+    return true;
+}
+
+/*
+* start recording to the empty buffer
+*/
+void Recorder::startRecording(CommandVector& /*cv*/)
+{
+    {
+        CriticalSectionLock lock;
+        writeIndex = 0;
+        recordCount = 0;
+        framesTruncated = 0;
+        state = RecorderState::Recording;
+    }
+    CdcStream::getInstance().setTextSuppressed(false);
+    std::cout << "sensor recording started; buffer capacity = " << RecorderCapacity << " records" << std::endl;
+}
+
+/*
+* stop recording or replay
+*/
+void Recorder::stop(CommandVector& /*cv*/)
+{
+    size_t count{0};
+    {
+        CriticalSectionLock lock;
+        state = RecorderState::Idle;
+        count = recordCount;
+    }
+    CdcStream::getInstance().setTextSuppressed(false);
+    std::cout << "records = " << count << ", truncated frames = " << framesTruncated << std::endl;
+    std::cout << "streamed records = " << recordsStreamed << ", dropped = " << recordsDropped << std::endl;
+}
+
+/*
+* write the header and all records to the console as raw bytes
+* the bytes are written to the stdout file handle directly, bypassing the stdio newline conversion
+*/
+void Recorder::dump(CommandVector& /*cv*/)
+{
+    size_t count{0};
+    size_t oldestIndex{0};
+    {
+        CriticalSectionLock lock;
+        state = RecorderState::Idle;
+        count = recordCount;
+        oldestIndex = (writeIndex + RecorderCapacity - recordCount) % RecorderCapacity;
+    }
+    CdcStream::getInstance().setTextSuppressed(false);
+    std::cout << "sensor recorder dump of " << count << " records:" << std::endl;
+
+    RecorderDumpHeader header{{'Y', 'R', 'E', 'C'}, RecorderDumpHeader::Version, sizeof(SensorRecord), static_cast<uint32_t>(count), SystemCoreClock};
+    FileHandle* console = mbed_file_handle(STDOUT_FILENO);
+    console->write(&header, sizeof(header));
+    for(size_t index = 0; index < count; index++)
+    {
+        console->write(&recordBuffer[(oldestIndex + index) % RecorderCapacity], sizeof(SensorRecord));
+    }
+    std::cout << std::endl;
+}
+
+/*
+* replay the recorded data in place of the live sensor data and inputs
+* one record is consumed per handler call, so the replay runs at the live IMU interrupt rate
+*/
+void Recorder::startReplay(CommandVector& /*cv*/)
+{
+    size_t count{0};
+    {
+        CriticalSectionLock lock;
+        count = recordCount;
+        if(count != 0)
+        {
+            replayCount = 0;
+            state = RecorderState::Replaying;
+        }
+    }
+    CdcStream::getInstance().setTextSuppressed(false);
+    if(count == 0)
+    {
+        std::cout << "no recorded data" << std::endl;
+        return;
+    }
+    std::cout << "replay of " << count << " records started" << std::endl;
+}
+
+/*
+* stream the live records over the USB serial port until stopped
+* the console and log text is suppressed while streaming, so the port carries the telemetry packets only;
+* any recorder command stops the streaming and resumes the text
+*/
+void Recorder::startStreaming(CommandVector& /*cv*/)
+{
+    std::cout << "sensor data streaming started; packet = 'YTLM' tag, size, sequence, " << sizeof(SensorRecord) << "-byte record, Fletcher-32 checksum" << std::endl;
+    // the text written so far is kept in the transmit buffer ahead of the first packet
+    CdcStream::getInstance().setTextSuppressed(true);
+    CriticalSectionLock lock;
+    recordsStreamed = 0;
+    recordsDropped = 0;
+    framesTruncated = 0;
+    streamSequence = 0;
+    state = RecorderState::Streaming;
+}
@@ -0,0 +1,65 @@
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include "AnalogAcquisition.h"
+#include "Console.h"
+#include "ImuAcquisition.h"
+#include "SensorRecord.h"
+#include <mbed.h>
+#include <array>
+
+static_assert(YokeInputs::NumberOfPotentiometers == AnalogAcquisition::NumberOfChannels, "the recorded inputs must match the analog acquisition");
+static_assert((ImuSampleDataSize == ImuFrame::SampleDataSize) && (MagnetometerSampleDataSize == ImuFrame::MagnetometerDataSize), "the record data must match the IMU frame data");
+
+enum struct RecorderState : uint32_t
+{
+    Idle,
+    Recording,
+    Replaying,
+    Streaming
+};
+
+/*
+Recorder of the raw sensor data and the yoke inputs to a RAM ring buffer
+the oldest records are overwritten when the buffer is full
+the recorded data can be dumped as a binary stream or replayed through the yoke handler
+in the streaming state the records are not stored, but sent as framed telemetry packets over the USB CDC-ACM interface,
+while the console text is suppressed
+record() and replay() are called in the IMU thread and the console commands in a lower priority thread;
+the state and the buffer indexes are changed together in critical sections, so both threads see them consistent
+the replay callback is called in the IMU thread before the first replayed record, so the handler can reset
+its filters and the sensor fusion state to the state after power-up
+the replay is not fully deterministic:
+- the handler calls without an IMU frame (missing interrupt) are not recorded and happen at their live times
+- the IMU frames with more than SensorRecord::MaxSamples samples are truncated
+- the persistent calibration references and the parameters changed after the recording are used as they are
+- the USB report suppression and scheduling depend on the host polling
+*/
+class Recorder
+{
+public:
+    Recorder();
+    void setReplayCallback(Callback<void()> cb) { replayCb = cb; }     // called in the IMU thread at the replay start
+    void record(const ImuFrame& frame, const YokeInputs& inputs);
+    bool replay(ImuFrame& frame, YokeInputs& inputs);
+    bool isReplaying() const { return state == RecorderState::Replaying; }
+    void startRecording(CommandVector& cv);
+    void stop(CommandVector& cv);
+    void dump(CommandVector& cv);
+    void startReplay(CommandVector& cv);
+    void startStreaming(CommandVector& cv);
+private:
+    void fillRecord(SensorRecord& record, const ImuFrame& frame, const YokeInputs& inputs);
+    void streamRecord(const ImuFrame& frame, const YokeInputs& inputs);
+    Callback<void()> replayCb{nullptr};
+    volatile RecorderState state{RecorderState::Idle};
+    size_t writeIndex{0};       // index of the next record to write
+    size_t recordCount{0};      // number of valid records in the buffer
+    size_t replayCount{0};      // number of records already replayed
+    uint32_t framesTruncated{0};    // recorded frames with more samples than fit in a record
+    uint32_t recordsStreamed{0};    // records sent in the telemetry stream
+    uint32_t recordsDropped{0};     // records not sent, because the USB transmit buffer was full
+    uint16_t streamSequence{0};     // sequence number of the next telemetry packet
+};
+
+#endif /* RECORDER_H_ */
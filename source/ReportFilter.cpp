@@ -0,0 +1,93 @@
+#include "ReportFilter.h"
+#include <cstdlib>
+
+// joystick axes of the reports
+static constexpr std::array<int16_t JoystickData::*, 5> AxesReportAxes     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+{
+    &JoystickData::X, &JoystickData::Y, &JoystickData::Rz, &JoystickData::Rx, &JoystickData::Ry
+};
+static constexpr std::array<int16_t JoystickData::*, 3> ControlsReportAxes     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+{
+    &JoystickData::Z, &JoystickData::slider, &JoystickData::dial
+};
+
+ReportFilter::ReportFilter(int16_t deadband, std::chrono::milliseconds keepAlivePeriod) :
+    deadband(deadband),
+    keepAlivePeriod(keepAlivePeriod)
+{
+    for(auto& reportState : reportStates)
+    {
+        reportState.keepAliveTimer.start();
+    }
+}
+
+/*
+apply the axis hysteresis to the axes of the report
+returns true if any of the held axes differs from the last sent report
+*/
+template<size_t NumberOfAxes> bool ReportFilter::holdAxes(const std::array<int16_t JoystickData::*, NumberOfAxes>& axes, JoystickData& report)
+{
+    constexpr int16_t AxisLimit = 0x7FFF;
+    bool isChanged = false;
+    for(auto axis : axes)
+    {
+        // the centre and the ends of the axis range are passed regardless of the deadband
+        int16_t value = report.*axis;
+        if((std::abs(value - heldData.*axis) > deadband) || (value == 0) || (value == AxisLimit) || (value == -AxisLimit))
+        {
+            heldData.*axis = value;
+        }
+        report.*axis = heldData.*axis;
+        isChanged = isChanged || (report.*axis != sentData.*axis);
+    }
+    return isChanged;
+}
+
+/*
+apply the axis hysteresis to the report fields of the report ID
+returns true if the report differs from the last sent report or the keep-alive report is due
+the caller counts a suppression with onReportSuppressed() when it sends no report at all
+*/
+bool ReportFilter::isReportDue(JoystickReportId reportId, JoystickData& report)
+{
+    bool isChanged = false;
+    if(reportId == JoystickReportId::Axes)
+    {
+        isChanged = holdAxes(AxesReportAxes, report);
+    }
+    else
+    {
+        isChanged = holdAxes(ControlsReportAxes, report);
+        isChanged = isChanged || (report.hat != sentData.hat) || (report.buttons != sentData.buttons);
+    }
+
+    const ReportState& reportState = reportStates[getIndex(reportId)];
+    return !reportState.isSent || isChanged || (reportState.keepAliveTimer.elapsed_time() >= keepAlivePeriod);
+}
+
+/*
+store the fields of the report passed to the USB device
+*/
+void ReportFilter::onReportSent(JoystickReportId reportId, const JoystickData& report)
+{
+    if(reportId == JoystickReportId::Axes)
+    {
+        for(auto axis : AxesReportAxes)
+        {
+            sentData.*axis = report.*axis;
+        }
+    }
+    else
+    {
+        for(auto axis : ControlsReportAxes)
+        {
+            sentData.*axis = report.*axis;
+        }
+        sentData.hat = report.hat;
+        sentData.buttons = report.buttons;
+    }
+    ReportState& reportState = reportStates[getIndex(reportId)];
+    reportState.isSent = true;
+    reportState.keepAliveTimer.reset();
+    reportsSent++;
+}
@@ -0,0 +1,40 @@
+#ifndef REPORTFILTER_H_
+#define REPORTFILTER_H_
+
+#include "USBJoystick.h"
+#include <mbed.h>
+#include <array>
+
+/*
+Change-driven filter of the joystick reports
+every axis is held at its last value until it moves by more than the deadband, so the noise of the low bits
+does not change the report; a report is due only when one of its held axes, the HAT switch or a button differs from
+the last sent report of the same report ID, or when the keep-alive period has elapsed since that report was sent
+*/
+class ReportFilter
+{
+public:
+    ReportFilter(int16_t deadband, std::chrono::milliseconds keepAlivePeriod);
+    bool isReportDue(JoystickReportId reportId, JoystickData& report);
+    void onReportSent(JoystickReportId reportId, const JoystickData& report);
+    void onReportSuppressed() { reportsSuppressed++; }
+    uint32_t getReportsSent() const { return reportsSent; }
+    uint32_t getReportsSuppressed() const { return reportsSuppressed; }
+private:
+    struct ReportState
+    {
+        bool isSent{false};                     // a report with this ID has been sent
+        Timer keepAliveTimer;                   // time elapsed since the last sent report with this ID
+    };
+    template<size_t NumberOfAxes> bool holdAxes(const std::array<int16_t JoystickData::*, NumberOfAxes>& axes, JoystickData& report);
+    static size_t getIndex(JoystickReportId reportId) { return static_cast<size_t>(reportId) - 1; }
+    int16_t deadband;                           // axis change not passed to the report
+    std::chrono::milliseconds keepAlivePeriod;  // maximum period between the sent reports of the same ID
+    JoystickData heldData{0};                   // axis values held by the hysteresis
+    JoystickData sentData{0};                   // the fields of the last sent reports
+    std::array<ReportState, 2> reportStates;    // states of the reports in the JoystickReportId order
+    uint32_t reportsSent{0};                    // reports sent to the USB device
+    uint32_t reportsSuppressed{0};              // report opportunities without any report, because no report differed from the last sent one
+};
+
+#endif /* REPORTFILTER_H_ */
@@ -0,0 +1,88 @@
+#include "RotaryEncoder.h"
+#include "Debouncer.h"
+#include <array>
+
+RotaryEncoder::RotaryEncoder(PinName pinA, PinName pinB, EventQueue& eventQueue) :
+    pinA(pinA),
+    pinB(pinB),
+    eventQueue(eventQueue)
+{
+    Debouncer::getInstance().addPin(pinA, PullUp);
+    Debouncer::getInstance().addPin(pinB, PullUp);
+    Debouncer::getInstance().addSampler(callback(this, &RotaryEncoder::onSample));
+}
+
+/*
+decode the encoder state transition (ISR context)
+*/
+void RotaryEncoder::onSample(const PortLevels& levels)
+{
+    // position change of the transition from the previous state (index bits 3-2) to the current state (index bits 1-0)
+    // right turn: 00 -> 10 -> 11 -> 01 -> 00; an invalid double transition is ignored
+    static constexpr std::array<int8_t, 16> TransitionTable{0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    // step multipliers of the shortest intervals between detents [sampling periods]
+    struct Acceleration
+    {
+        uint32_t maxInterval;
+        int multiplier;
+    };
+    static constexpr std::array<Acceleration, 2> AccelerationTable{{{20, 4}, {50, 2}}};     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    constexpr uint8_t DetentState = 0x03U;      // both pins high at rest
+    constexpr int8_t MinTransitions = 2;        // transitions in one direction required for a step
+
+    auto newState = static_cast<uint8_t>((getPinLevel(levels, pinA) << 1U) | getPinLevel(levels, pinB));
+    if(sampleCounter < AccelerationTable.back().maxInterval)
+    {
+        sampleCounter++;
+    }
+    if(newState == state)
+    {
+        return;
+    }
+    transitions = static_cast<int8_t>(transitions + TransitionTable[(state << 2U) | newState]);     //NOLINT(hicpp-signed-bitwise)
+    state = newState;
+
+    if((state == DetentState) && ((transitions >= MinTransitions) || (transitions <= -MinTransitions)))
+    {
+        int steps = (transitions > 0) ? 1 : -1;
+        for(const auto& acceleration : AccelerationTable)
+        {
+            if(sampleCounter < acceleration.maxInterval)
+            {
+                steps *= acceleration.multiplier;
+                break;
+            }
+        }
+        transitions = 0;
+        sampleCounter = 0;
+        core_util_atomic_fetch_add_s32(&pendingSteps, steps);
+        if(!core_util_atomic_exchange_bool(&isDispatchPending, true))
+        {
+            // no event is pending - queue one for this batch of steps
+            if(eventQueue.call(callback(this, &RotaryEncoder::dispatchSteps)) == 0)
+            {
+                // the event queue is full - the steps stay pending and the next step retries
+                core_util_atomic_store_bool(&isDispatchPending, false);
+            }
+        }
+    }
+    else if(state == DetentState)
+    {
+        // back at rest without a full step
+        transitions = 0;
+    }
+}
+
+/*
+deliver all pending steps to the user callback (event queue context)
+*/
+void RotaryEncoder::dispatchSteps()
+{
+    // the steps counted after this point queue a new event
+    core_util_atomic_store_bool(&isDispatchPending, false);
+    int32_t steps = core_util_atomic_exchange_s32(&pendingSteps, 0);
+    if((steps != 0) && userCb)
+    {
+        userCb(steps);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef ROTARYENCODER_H_
+#define ROTARYENCODER_H_
+
+#include "GpioSnapshot.h"
+#include <mbed.h>
+
+/*
+Quadrature rotary encoder with velocity acceleration
+the encoder pins are sampled by the Debouncer ticker and decoded with a 4-state transition table,
+so contact bouncing only moves the position back and forth and no edge interrupts are used
+the steps counted in the interrupt context are delivered in batches: one event is queued until the user callback
+has taken all pending steps; the callback is called with the signed number of steps (positive = right turn)
+if the event queue is full, the steps are kept and the next step queues the event again
+*/
+class RotaryEncoder
+{
+public:
+    RotaryEncoder(PinName pinA, PinName pinB, EventQueue& eventQueue);
+    void setCallback(Callback<void(int)> cb) { userCb = cb; }
+private:
+    void onSample(const PortLevels& levels);
+    void dispatchSteps();
+    PinName pinA;
+    PinName pinB;
+    EventQueue& eventQueue;
+    Callback<void(int)> userCb{nullptr};
+    uint8_t state{0};                   // the last sampled levels: pin A (bit 1), pin B (bit 0)
+    int8_t transitions{0};              // transitions counted since the last detent
+    uint32_t sampleCounter{0};          // sampling periods elapsed since the last detent
+    volatile int32_t pendingSteps{0};   // steps not yet delivered to the user callback
+    volatile bool isDispatchPending{false};     // the event delivering the pending steps is queued
+};
+
+#endif /* ROTARYENCODER_H_ */
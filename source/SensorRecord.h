@@ -0,0 +1,135 @@
+#ifndef SENSORRECORD_H_
+#define SENSORRECORD_H_
+
+#include "Convert.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+record format of the sensor recorder
+the layout is the record format of the binary dump, so it does not depend on mbed
+and the host replay tool reads the dumps with the same definitions
+*/
+
+constexpr size_t ImuSampleDataSize = 12;            // gyroscope and accelerometer output registers of one FIFO sample
+constexpr size_t MagnetometerSampleDataSize = 6;    // magnetometer output registers
+
+/*
+yoke input readings of one handler call
+the handler processes these values only, so they can be recorded and replayed
+*/
+struct YokeInputs       //NOLINT(altera-struct-pack-align)
+{
+    static constexpr size_t NumberOfPotentiometers = 6;
+    float deltaT;           // time elapsed since the previous handler call [s]
+    std::array<float, NumberOfPotentiometers> potentiometers;   // potentiometer readings in the range <0,1>
+    uint16_t switches;      // bitmap of the switch input levels
+    uint8_t hatPosition;    // HAT switch position 0 (center) or 1..8
+};
+
+/*
+one record of the sensor recorder
+*/
+struct SensorRecord     //NOLINT(altera-struct-pack-align)
+{
+    static constexpr size_t MaxSamples = 8;     // gyroscope/accelerometer samples stored per record; the rest of the frame is truncated
+    uint32_t interruptTime;     // cycle counter value at the IMU interrupt
+    YokeInputs inputs;
+    uint8_t sampleCount;        // number of the stored gyroscope/accelerometer samples
+    uint8_t isValid;            // 0 if any transfer of the IMU frame has failed
+    uint8_t isMagnetometerFresh;    // 1 if the magnetometer data is a new sample
+    std::array<uint8_t, MaxSamples * ImuSampleDataSize> gyroAccelData;    // raw gyroscope and accelerometer output registers
+    std::array<uint8_t, MagnetometerSampleDataSize> magnetometerData;     // raw magnetometer output registers
+};
+
+static_assert(sizeof(SensorRecord) == 144, "the record size is a part of the dump format");
+
+// header of the binary dump, followed by the records from the oldest one
+struct RecorderDumpHeader       //NOLINT(altera-struct-pack-align)
+{
+    static constexpr uint16_t Version = 2;
+    std::array<char, 4> tag;    // "YREC"
+    uint16_t version;           // dump format version
+    uint16_t recordSize;        // size of one record in bytes
+    uint32_t recordCount;       // number of records in the dump
+    uint32_t coreClock;         // frequency of the cycle counter of the interrupt time stamps [Hz]
+};
+
+/*
+packet of the telemetry stream
+the console text is suppressed while streaming, but it may precede the first packet, so the packets are framed:
+the tag marks the packet start, the payload size and the checksum reject a false tag in other data
+and the sequence number shows the dropped packets
+*/
+struct TelemetryPacket      //NOLINT(altera-struct-pack-align)
+{
+    std::array<char, 4> tag;    // "YTLM"
+    uint16_t payloadSize;       // size of the record in bytes
+    uint16_t sequence;          // packet counter incremented for every packet, also for the dropped ones
+    SensorRecord record;
+    uint32_t checksum;          // Fletcher-32 checksum of the 16-bit words from payloadSize to the end of the record
+};
+
+static_assert(sizeof(TelemetryPacket) == 156, "the packet size is a part of the stream format");
+
+/*
+Fletcher-32 checksum of 16-bit little-endian words
+the sums are reduced once per 359 words, so the 32-bit sums never overflow
+*/
+inline uint32_t getFletcher32(const uint8_t* data, size_t numberOfWords)
+{
+    constexpr size_t MaxBlockWords = 359;
+    constexpr uint32_t Modulus = 65535;
+    uint32_t sum1 = 0xFFFFU;
+    uint32_t sum2 = 0xFFFFU;
+    while(numberOfWords != 0)
+    {
+        size_t blockWords = (numberOfWords < MaxBlockWords) ? numberOfWords : MaxBlockWords;
+        numberOfWords -= blockWords;
+        for(size_t word = 0; word < blockWords; word++)
+        {
+            sum1 += static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8U);      //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            sum2 += sum1;
+            data += 2;      //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+        sum1 = (sum1 & Modulus) + (sum1 >> 16U);
+        sum2 = (sum2 & Modulus) + (sum2 >> 16U);
+    }
+    sum1 = (sum1 & Modulus) + (sum1 >> 16U);
+    sum2 = (sum2 & Modulus) + (sum2 >> 16U);
+    return (sum2 << 16U) | sum1;
+}
+
+// checksum of the telemetry packet fields from payloadSize to the end of the record
+inline uint32_t getTelemetryChecksum(const TelemetryPacket& packet)
+{
+    constexpr size_t ChecksumStart = offsetof(TelemetryPacket, payloadSize);
+    constexpr size_t ChecksumSize = offsetof(TelemetryPacket, checksum) - ChecksumStart;
+    return getFletcher32(reinterpret_cast<const uint8_t*>(&packet) + ChecksumStart, ChecksumSize / 2);     //NOLINT(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+/*
+parse the raw output registers of one gyroscope/accelerometer FIFO sample
+the gyroscope registers precede the accelerometer registers, both in the Z, Y, X order of the sensor axes
+*/
+inline void parseImuSample(const uint8_t* sampleData, Vector3D<int16_t>& gyroscopeData, Vector3D<int16_t>& accelerometerData)
+{
+    std::memcpy(&gyroscopeData.Z, &sampleData[0], sizeof(int16_t));        //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::memcpy(&gyroscopeData.Y, &sampleData[2], sizeof(int16_t));        //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::memcpy(&gyroscopeData.X, &sampleData[4], sizeof(int16_t));        //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::memcpy(&accelerometerData.Z, &sampleData[6], sizeof(int16_t));    //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    std::memcpy(&accelerometerData.Y, &sampleData[8], sizeof(int16_t));    //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    std::memcpy(&accelerometerData.X, &sampleData[10], sizeof(int16_t));   //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+}
+
+// parse the raw magnetometer output registers in the X, Y, Z order
+inline void parseMagnetometerSample(const uint8_t* sampleData, Vector3D<int16_t>& magnetometerData)
+{
+    std::memcpy(&magnetometerData.X, &sampleData[0], sizeof(int16_t));     //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::memcpy(&magnetometerData.Y, &sampleData[2], sizeof(int16_t));     //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::memcpy(&magnetometerData.Z, &sampleData[4], sizeof(int16_t));     //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+#endif /* SENSORRECORD_H_ */
@@ -0,0 +1,32 @@
+#ifndef SORTEDMEDIAN_H_
+#define SORTEDMEDIAN_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/*
+reference moving median with a sorted vector, as used before the heap-based FilterMM
+the oldest value is erased from the sorted buffer and the new value is inserted at its sorted position
+the on-target and the host benchmarks compare FilterMM with this class
+*/
+class SortedMedian
+{
+public:
+    explicit SortedMedian(size_t size) : size(size), unsortedBuffer(size, 0.0F), sortedBuffer(size, 0.0F) {}
+    float getValue() const { return sortedBuffer[size / 2]; }
+    void calculate(float newInputValue)
+    {
+        sortedBuffer.erase(std::find(sortedBuffer.begin(), sortedBuffer.end(), unsortedBuffer[headIndex]));
+        sortedBuffer.insert(std::upper_bound(sortedBuffer.begin(), sortedBuffer.end(), newInputValue), newInputValue);
+        unsortedBuffer[headIndex] = newInputValue;
+        headIndex = (headIndex + 1) % size;
+    }
+private:
+    size_t size;
+    size_t headIndex{0};
+    std::vector<float> unsortedBuffer;
+    std::vector<float> sortedBuffer;
+};
+
+#endif /* SORTEDMEDIAN_H_ */
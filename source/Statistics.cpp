@@ -30,4 +30,15 @@ void listThreads(CommandVector&  /*cv*/)
         std::cout << stats[i].stack_size << ", ";               //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
         std::cout << stats[i].stack_space << std::endl;         //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
+}
+
+/*
+enable the DWT cycle counter for time measurements in CPU clock cycles
+the counter is never reset, as the interrupt time stamps and the open profiler stages use it concurrently;
+all users take the unsigned difference of two counter values, which is correct across the wrap-around
+*/
+void enableCycleCounter()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
\ No newline at end of file
@@ -13,5 +13,9 @@
 #define MAX_THREAD_STATS    0x8
 
 void listThreads(CommandVector& cv);
+void enableCycleCounter();
+
+// current value of the DWT cycle counter
+inline uint32_t getCycleCount() { return DWT->CYCCNT; }
 
 #endif /* STATISTICS_H_ */
\ No newline at end of file
@@ -1,84 +1,54 @@
 #include "Switch.h"
+#include "Debouncer.h"
 
-Switch::Switch(SwitchType switchType, PinName levelPin, EventQueue& eventQueue, float debounceTimeout, PinName directionPin) :
+Switch::Switch(SwitchType switchType, PinName levelPin, EventQueue& eventQueue) :
     switchType(switchType),
-    level(levelPin, PullUp),
-    eventQueue(eventQueue),
-    debounceTimeout(debounceTimeout),
-    direction(directionPin, PullUp)
+    levelPin(levelPin),
+    eventQueue(eventQueue)
 {
-    level.fall(callback(this, &Switch::onLevelFallInterrupt));
-    level.rise(callback(this, &Switch::onLevelRiseInterrupt));
+    Debouncer::getInstance().addPin(levelPin, PullUp);
+    Debouncer::getInstance().addListener(levelPin, callback(this, &Switch::onLevelChange));
 }
 
-void Switch::onLevelFallInterrupt()
+/*
+debounced level change of the level pin (ISR context)
+*/
+void Switch::onLevelChange(const PortLevels& levels)
 {
-    if(stableHigh)
+    if(!userCb)
+    {
+        return;
+    }
+    if(getPinLevel(levels, levelPin) == 0)
     {
         // execute user callback on falling edge
-        if(userCb)
+        switch(switchType)
         {
-            switch(switchType)
-            {
-                case SwitchType::RotaryEncoder:
-                    eventQueue.call(userCb, direction.read());
-                    break;
-                case SwitchType::Pushbutton:
-                case SwitchType::ToggleSwitch:
-                    eventQueue.call(userCb, 0);
-                    break;
-                default:
-                    break;
-            }
+            case SwitchType::Pushbutton:
+            case SwitchType::ToggleSwitch:
+                eventQueue.call(userCb, 0);
+                break;
+            default:
+                break;
         }
-        stableHigh = false;
     }
-    levelDebounceTimeout.attach(callback(this, &Switch::onDebounceTimeoutCb), std::chrono::microseconds(static_cast<uint64_t>(debounceTimeout * UsInSec)));
-}
-
-void Switch::onLevelRiseInterrupt()
-{
-    if(stableLow)
+    else
     {
         // execute user callback on rising edge
-        if(userCb)
+        switch(switchType)
         {
-            switch(switchType)
-            {
-                case SwitchType::ToggleSwitch:
-                    eventQueue.call(userCb, 1);
-                    break;
-                case SwitchType::Pushbutton:
-                case SwitchType::RotaryEncoder:
-                default:
-                    break;
-            }
+            case SwitchType::ToggleSwitch:
+                eventQueue.call(userCb, 1);
+                break;
+            case SwitchType::Pushbutton:
+            default:
+                break;
         }
-        stableLow = false;
     }
-    levelDebounceTimeout.attach(callback(this, &Switch::onDebounceTimeoutCb), std::chrono::microseconds(static_cast<uint64_t>(debounceTimeout * UsInSec)));
-}
-
-void Switch::onDebounceTimeoutCb()
-{
-    if(level.read() == 1)
-    {
-        stableHigh = true;
-    }
-    else
-    {
-        stableLow = true;
-    }
-}
-
-Hat::Hat(PinName northPin, PinName eastPin, PinName southPin, PinName westPin) :
-    switchBus(northPin, eastPin, southPin, westPin)
-{
-    switchBus.mode(PullUp);
 }
 
 /*
-get position of the HAT switch
+get position of the HAT switch from the levels of the north (bit 0), east, south and west (bit 3) pins
 0-neutral
 1-N
 2-NE
@@ -89,9 +59,9 @@ get position of the HAT switch
 7-W
 8-NW
 */
-uint8_t Hat::getPosition()
+uint8_t Hat::decodePosition(uint8_t busValue)
 {
-    auto busValue = static_cast<uint8_t>(switchBus.read() & 0x0F);       //NOLINT(hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-magic-numbers)
+    busValue &= 0x0F;       //NOLINT(hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-magic-numbers)
     uint8_t hatPosition{0};
     switch(busValue)
     {
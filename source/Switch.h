@@ -1,50 +1,41 @@
 #ifndef SWITCH_H_
 #define SWITCH_H_
 
+#include "GpioSnapshot.h"
 #include <mbed.h>
 
 enum class SwitchType
 {
     Pushbutton,
-    ToggleSwitch,
-    RotaryEncoder
+    ToggleSwitch
 };
 
 /*
-Class of various types of switches (pushbutton, toggle switch, rotary encoder)
-Caution! Do not use the same levelPin number for several objects
+Class of various types of switches (pushbutton, toggle switch)
+the switch levels are debounced by the Debouncer; the user callback is queued in the event queue
 */
 class Switch
 {
 public:
-    Switch(SwitchType switchType, PinName levelPin, EventQueue& eventQueue, float debounceTimeout = 0.01F, PinName directionPin = NC);      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-magic-numbers)
+    Switch(SwitchType switchType, PinName levelPin, EventQueue& eventQueue);
     void setCallback(Callback<void(uint8_t)> cb) { userCb = cb; }
 private:
-    void onLevelFallInterrupt();
-    void onLevelRiseInterrupt();
-    void onDebounceTimeoutCb();
+    void onLevelChange(const PortLevels& levels);
     SwitchType switchType;
-    InterruptIn level;
+    PinName levelPin;
     EventQueue& eventQueue;
-    float debounceTimeout;
-    DigitalIn direction;
-    Timeout levelDebounceTimeout;
-    bool stableHigh{true};
-    bool stableLow{false};
-    Callback<void(uint8_t)> userCb{nullptr};    // callback function called with argument=0 (left turn) or 1 (right turn)
-    static constexpr uint32_t UsInSec = 1000000U; 
+    Callback<void(uint8_t)> userCb{nullptr};    // callback function called with argument=0 (pressed / switched on) or 1 (switched off)
 };
 
 /*
-class of the HAT switch
+decoder of the HAT switch position
+the HAT pins are debounced and read together with the other yoke inputs, so no pins are owned here
 */
 class Hat
 {
 public:
-    Hat(PinName northPin, PinName eastPin, PinName southPin, PinName westPin);
-    uint8_t getPosition();
-private:
-    BusIn switchBus;
+    Hat() = delete;
+    static uint8_t decodePosition(uint8_t busValue);
 };
 
 #endif /* ENCSWITCH_H_ODER_H_ */
\ No newline at end of file
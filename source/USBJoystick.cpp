@@ -6,14 +6,111 @@
  */
 
 #include "USBJoystick.h"
+#include "CdcStream.h"
 #include "Convert.h"
+#include "EndpointResolver.h"
+#include "HidDescriptor.h"
 #include "Logger.h"
 #include "usb_phy_api.h"
+#include <cstddef>
+#include <cstring>
 #include <iomanip>
 
+// interfaces of the composite device
+constexpr uint8_t HidInterface = 0;
+constexpr uint8_t CdcControlInterface = 1;
+constexpr uint8_t CdcDataInterface = 2;
+
+// HID report types of the GET_REPORT and SET_REPORT requests
+constexpr uint8_t InputReportType = 0x01U;
+constexpr uint8_t FeatureReportType = 0x03U;
+
+// CDC class requests
+constexpr uint8_t CdcSetLineCoding = 0x20U;
+constexpr uint8_t CdcGetLineCoding = 0x21U;
+constexpr uint8_t CdcSetControlLineState = 0x22U;
+
+// HID usages of the joystick report
+constexpr uint8_t GenericDesktopPage = 0x01U;
+constexpr uint8_t ButtonPage = 0x09U;
+constexpr uint16_t VendorPage = 0xFF00U;
+constexpr uint8_t JoystickUsage = 0x04U;
+constexpr uint8_t HatSwitchUsage = 0x39U;
+constexpr uint8_t DegreesUnit = 0x14U;      // Eng Rot: Angular Position
+
+// fields of the joystick reports in the order of the report structure members
+constexpr HidReportFields<5> JoystickAxesReportFields     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+{
+    static_cast<uint8_t>(JoystickReportId::Axes),
+    HidItem::Input,
+    {{
+        // usage page, usage, count, size, logical min, max, physical min, max, unit, input flags, pointer, offset
+        {GenericDesktopPage, 0x30, 1, 16, -32767, 32767, 0, 0, 0, HidVariable, true, offsetof(JoystickAxesReport, X)},      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {GenericDesktopPage, 0x31, 1, 16, -32767, 32767, 0, 0, 0, HidVariable, true, offsetof(JoystickAxesReport, Y)},      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {GenericDesktopPage, 0x35, 1, 16, -32767, 32767, 0, 0, 0, HidVariable, true, offsetof(JoystickAxesReport, Rz)},     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {GenericDesktopPage, 0x33, 1, 16, 0, 32767, 0, 0, 0, HidVariable, true, offsetof(JoystickAxesReport, Rx)},          //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {GenericDesktopPage, 0x34, 1, 16, 0, 32767, 0, 0, 0, HidVariable, true, offsetof(JoystickAxesReport, Ry)}           //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }}
+};
+
+constexpr HidReportFields<6> JoystickControlsReportFields     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+{
+    static_cast<uint8_t>(JoystickReportId::Controls),
+    HidItem::Input,
+    {{
+        // usage page, usage, count, size, logical min, max, physical min, max, unit, input flags, pointer, offset
+        {GenericDesktopPage, 0x32, 1, 16, -32767, 32767, 0, 0, 0, HidVariable, true, offsetof(JoystickControlsReport, Z)},      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {GenericDesktopPage, 0x36, 1, 16, 0, 32767, 0, 0, 0, HidVariable, true, offsetof(JoystickControlsReport, slider)},      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {GenericDesktopPage, 0x37, 1, 16, 0, 32767, 0, 0, 0, HidVariable, true, offsetof(JoystickControlsReport, dial)},        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {GenericDesktopPage, HatSwitchUsage, 1, 4, 1, 8, 0, 315, DegreesUnit, HidVariableNull, false, offsetof(JoystickControlsReport, hat)},     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {0, 0, 1, 4, 0, 0, 0, 0, 0, HidConstant, false, 0},                                                                     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        {ButtonPage, 1, 32, 1, 0, 1, 0, 0, 0, HidVariable, false, offsetof(JoystickControlsReport, buttons)}                    //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }}
+};
+
+// the parameter data is a byte array for the host tool; its layout is defined by the parameter owner
+constexpr HidReportFields<1> JoystickParameterReportFields
+{
+    static_cast<uint8_t>(JoystickReportId::Parameters),
+    HidItem::Feature,
+    {{
+        // usage page, usage, count, size, logical min, max, physical min, max, unit, item flags, pointer, offset
+        {VendorPage, 0x01, JoystickParameterDataSize, 8, 0, 255, 0, 0, 0, HidVariable, false, offsetof(JoystickParameterReport, data)}    //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }}
+};
+
+static_assert(getHidReportSize(JoystickAxesReportFields) == sizeof(JoystickAxesReport) * 8, "joystick axes report fields do not match the JoystickAxesReport size");
+static_assert(isHidReportLayoutValid(JoystickAxesReportFields), "joystick axes report fields do not match the JoystickAxesReport member offsets");
+static_assert(getHidReportSize(JoystickControlsReportFields) == sizeof(JoystickControlsReport) * 8, "joystick controls report fields do not match the JoystickControlsReport size");
+static_assert(isHidReportLayoutValid(JoystickControlsReportFields), "joystick controls report fields do not match the JoystickControlsReport member offsets");
+static_assert(getHidReportSize(JoystickParameterReportFields) == sizeof(JoystickParameterReport) * 8, "parameter report fields do not match the JoystickParameterReport size");
+static_assert(sizeof(JoystickControlsReport) <= MAX_HID_REPORT_SIZE, "joystick report exceeds the HID report size");
+static_assert(sizeof(JoystickParameterReport) <= MAX_PACKET_SIZE_EP0, "parameter report exceeds the control endpoint packet size");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "HID reports are little-endian copies of the report structures");
+
+// the descriptor is built twice: first to get its length, then in an array of this length
+constexpr size_t JoystickReportDescriptorLength =
+    makeHidDescriptor<1>(GenericDesktopPage, JoystickUsage, JoystickAxesReportFields, JoystickControlsReportFields, JoystickParameterReportFields).length;
+constexpr HidDescriptor<JoystickReportDescriptorLength> JoystickReportDescriptor =
+    makeHidDescriptor<JoystickReportDescriptorLength>(GenericDesktopPage, JoystickUsage, JoystickAxesReportFields, JoystickControlsReportFields, JoystickParameterReportFields);
+
 USBJoystick::USBJoystick(uint16_t vendorId, uint16_t productId, uint16_t productRelease, bool blocking) :
-    USBHID(get_usb_phy(), 0, 0, vendorId, productId, productRelease)
+    USBHID(get_usb_phy(), 0, 0, vendorId, productId, productRelease),
+    vendorId(vendorId),
+    productId(productId),
+    productRelease(productRelease)
 {
+    // the endpoints of USBHID are resolved again in the same order, so the CDC endpoints get the next free ones
+    EndpointResolver resolver(endpoint_table());
+    resolver.endpoint_ctrl(MAX_PACKET_SIZE_EP0);
+    resolver.endpoint_in(USB_EP_TYPE_INT, MAX_HID_REPORT_SIZE);
+    resolver.endpoint_out(USB_EP_TYPE_INT, MAX_HID_REPORT_SIZE);
+    cdcNotificationIn = resolver.endpoint_in(USB_EP_TYPE_INT, CdcNotificationSize);
+    cdcBulkIn = resolver.endpoint_in(USB_EP_TYPE_BULK, CdcPacketSize);
+    cdcBulkOut = resolver.endpoint_out(USB_EP_TYPE_BULK, CdcPacketSize);
+    MBED_ASSERT(resolver.valid());
+    CdcStream::getInstance().setTransmitCallback(callback(this, &USBJoystick::startCdcTransmit));
+
     if (blocking)
     {
         LOG_INFO(std::hex << setfill('0') << setw(4) << "Connecting USB HID joystick device (VID=0x" << vendorId << ", PID=0x" << productId
@@ -31,64 +128,51 @@ USBJoystick::USBJoystick(uint16_t vendorId, uint16_t productId, uint16_t product
 
 USBJoystick::~USBJoystick()
 {
+    CdcStream::getInstance().setTransmitCallback(nullptr);
     deinit();
 }
 
 const uint8_t* USBJoystick::report_desc()
 {
-    static const uint8_t report_descriptor[] =      //NOLINT(hicpp-avoid-c-arrays,modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+    reportLength = JoystickReportDescriptor.length;
+    return static_cast<const uint8_t*>(JoystickReportDescriptor.data);
+}
+
+/*
+* Get device descriptor
+* the composite device with the interface association of the CDC interfaces uses the miscellaneous device class
+*/
+const uint8_t* USBJoystick::device_desc()
+{
+    constexpr uint16_t UsbVersion = 0x0200U;
+    constexpr uint8_t MiscellaneousClass = 0xEFU;
+    constexpr uint8_t CommonSubclass = 0x02U;
+    constexpr uint8_t InterfaceAssociationProtocol = 0x01U;
+    uint8_t deviceDescriptorTemp[] =        //NOLINT(hicpp-avoid-c-arrays,modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
     {
-        0x05, 0x01,                    // USAGE_PAGE (Generic Desktop)
-        0x09, 0x04,                    // USAGE (Joystick)
-        0xa1, 0x01,                    // COLLECTION (Application)
-        0x05, 0x01,                    //   USAGE_PAGE (Generic Desktop)
-        0x09, 0x01,                    //   USAGE (Pointer)
-        0xa1, 0x00,                    //   COLLECTION (Physical)
-        0x75, 0x10,                    //     REPORT_SIZE (16)
-        0x16, 0x01, 0x80,              //     LOGICAL_MINIMUM (-32767)
-        0x26, 0xff, 0x7f,              //     LOGICAL_MAXIMUM (32767)
-        0x09, 0x30,                    //     USAGE (X)
-        0x09, 0x31,                    //     USAGE (Y)
-        0x09, 0x32,                    //     USAGE (Z)
-        0x09, 0x35,                    //     USAGE (Rz)
-        0x95, 0x04,                    //     REPORT_COUNT (4)
-        0x81, 0x02,                    //     INPUT (Data,Var,Abs)
-        0x15, 0x00,                    //     LOGICAL_MINIMUM (0)
-        0x26, 0xff, 0x7f,              //     LOGICAL_MAXIMUM (32767)
-        0x09, 0x33,                    //     USAGE (Rx)
-        0x09, 0x34,                    //     USAGE (Ry)
-        0x09, 0x36,                    //     USAGE (slider)
-        0x09, 0x37,                    //     USAGE (dial)
-        0x95, 0x04,                    //     REPORT_COUNT (4)
-        0x81, 0x02,                    //     INPUT (Data,Var,Abs)
-        0xc0,                          //   END_COLLECTION
-        0x09, 0x39,                    //   USAGE (Hat switch)
-        0x15, 0x01,                    //   LOGICAL_MINIMUM (1)
-        0x25, 0x08,                    //   LOGICAL_MAXIMUM (8)
-        0x35, 0x00,                    //   PHYSICAL_MINIMUM (0)
-        0x46, 0x3b, 0x01,              //   PHYSICAL_MAXIMUM (315)
-        0x65, 0x14,                    //   UNIT (Eng Rot:Angular Pos)
-        0x75, 0x04,                    //   REPORT_SIZE (4)
-        0x95, 0x01,                    //   REPORT_COUNT (1)
-        0x81, 0x42,                    //   INPUT (Data,Var,Abs, Null)
-        0x75, 0x04,                    //   REPORT_SIZE (4)
-        0x95, 0x01,                    //   REPORT_COUNT (1)
-        0x81, 0x41,                    //   INPUT (Cnst,Ary,Abs,Null)
-        0x05, 0x09,                    //   USAGE_PAGE (Button)
-        0x19, 0x01,                    //   USAGE_MINIMUM (Button 1)
-        0x29, 0x20,                    //   USAGE_MAXIMUM (Button 32)
-        0x15, 0x00,                    //   LOGICAL_MINIMUM (0)
-        0x25, 0x01,                    //   LOGICAL_MAXIMUM (1)
-        0x75, 0x01,                    //   REPORT_SIZE (1)
-        0x95, 0x20,                    //   REPORT_COUNT (16)
-        0x55, 0x00,                    //   UNIT_EXPONENT (0)
-        0x65, 0x00,                    //   UNIT (None)
-        0x81, 0x02,                    //   INPUT (Data,Var,Abs)
-        0xc0                           // END_COLLECTION
+        DEVICE_DESCRIPTOR_LENGTH,           // bLength
+        DEVICE_DESCRIPTOR,                  // bDescriptorType
+        LO8(UsbVersion),                    // bcdUSB (LSB)
+        HI8(UsbVersion),                    // bcdUSB (MSB)
+        MiscellaneousClass,                 // bDeviceClass
+        CommonSubclass,                     // bDeviceSubClass
+        InterfaceAssociationProtocol,       // bDeviceprotocol
+        MAX_PACKET_SIZE_EP0,                // bMaxPacketSize0
+        LO8(vendorId),                      // idVendor (LSB)
+        HI8(vendorId),                      // idVendor (MSB)
+        LO8(productId),                     // idProduct (LSB)
+        HI8(productId),                     // idProduct (MSB)
+        LO8(productRelease),                // bcdDevice (LSB)
+        HI8(productRelease),                // bcdDevice (MSB)
+        STRING_OFFSET_IMANUFACTURER,        // iManufacturer
+        STRING_OFFSET_IPRODUCT,             // iProduct
+        STRING_OFFSET_ISERIAL,              // iSerialNumber
+        0x01                                // bNumConfigurations
     };
 
-    reportLength = sizeof(report_descriptor);
-    return static_cast<const uint8_t*>(report_descriptor);
+    MBED_ASSERT(sizeof(deviceDescriptorTemp) == sizeof(deviceDescriptor));
+    memcpy(static_cast<void*>(deviceDescriptor), static_cast<void*>(deviceDescriptorTemp), sizeof(deviceDescriptor));
+    return static_cast<const uint8_t*>(deviceDescriptor);
 }
 
 const uint8_t* USBJoystick::configuration_desc(uint8_t index)
@@ -99,13 +183,24 @@ const uint8_t* USBJoystick::configuration_desc(uint8_t index)
     }
 
     const uint8_t DefaultConfiguration = 1;
+    constexpr uint8_t InterfaceAssociationDescriptorLength = 8;
+    constexpr uint8_t InterfaceAssociationDescriptor = 0x0B;
+    constexpr uint8_t CdcFunctionalDescriptorsLength = 5 + 5 + 4 + 5;
     const uint16_t TotalDescriptorLength = CONFIGURATION_DESCRIPTOR_LENGTH + INTERFACE_DESCRIPTOR_LENGTH
-                                         + HID_DESCRIPTOR_LENGTH + 2 * ENDPOINT_DESCRIPTOR_LENGTH; 
+                                         + HID_DESCRIPTOR_LENGTH + 2 * ENDPOINT_DESCRIPTOR_LENGTH
+                                         + InterfaceAssociationDescriptorLength + 2 * INTERFACE_DESCRIPTOR_LENGTH
+                                         + CdcFunctionalDescriptorsLength + 3 * ENDPOINT_DESCRIPTOR_LENGTH;
     constexpr uint8_t BmAttributes = (1U << 6U) | (1U << 7U);   
     const uint16_t HidVersion = HID_VERSION_1_11;
     uint16_t reportDescriptorLength = report_desc_length();
     const uint16_t MaxHIDReportSize = MAX_HID_REPORT_SIZE;
     const uint8_t PollInterval = 1;     // host polling interval [ms]
+    constexpr uint8_t CdcClass = 0x02;
+    constexpr uint8_t CdcAcmSubclass = 0x02;
+    constexpr uint8_t CdcDataClass = 0x0A;
+    constexpr uint8_t CsInterface = 0x24;
+    constexpr uint16_t CdcVersion = 0x0110;
+    constexpr uint8_t NotificationInterval = 16;    // [ms]
 
     uint8_t configurationDescriptorTemp[] =     //NOLINT(hicpp-avoid-c-arrays,modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
     {
@@ -113,7 +208,7 @@ const uint8_t* USBJoystick::configuration_desc(uint8_t index)
         CONFIGURATION_DESCRIPTOR,           // bDescriptorType
         LO8(TotalDescriptorLength),         // wTotalLength (LSB)
         HI8(TotalDescriptorLength),         // wTotalLength (MSB)
-        0x01,                               // bNumInterfaces
+        0x03,                               // bNumInterfaces
         DefaultConfiguration,               // bConfigurationValue
         0x00,                               // iConfiguration
         BmAttributes,                       // bmAttributes
@@ -121,9 +216,9 @@ const uint8_t* USBJoystick::configuration_desc(uint8_t index)
         /************** Descriptor of joystick interface ****************/
         INTERFACE_DESCRIPTOR_LENGTH,        // bLength
         INTERFACE_DESCRIPTOR,               // bDescriptorType
-        0x00,                               // bInterfaceNumber
+        HidInterface,                       // bInterfaceNumber
         0x00,                               // bAlternateSetting
-        0x01,                               // bNumEndpoints
+        0x02,                               // bNumEndpoints
         HID_CLASS,                          // bInterfaceClass
         HID_SUBCLASS_NONE,                  // bInterfaceSubClass
         HID_PROTOCOL_NONE,                  // bInterfaceProtocol
@@ -153,7 +248,86 @@ const uint8_t* USBJoystick::configuration_desc(uint8_t index)
         E_INTERRUPT,                        // bmAttributes
         LO8(MaxHIDReportSize),              // wMaxPacketSize (LSB)
         HI8(MaxHIDReportSize),              // wMaxPacketSize (MSB)
-        PollInterval                        // bInterval (milliseconds)
+        PollInterval,                       // bInterval (milliseconds)
+
+        /************** Interface association of the CDC-ACM interfaces ****************/
+        InterfaceAssociationDescriptorLength,   // bLength
+        InterfaceAssociationDescriptor,     // bDescriptorType
+        CdcControlInterface,                // bFirstInterface
+        0x02,                               // bInterfaceCount
+        CdcClass,                           // bFunctionClass
+        CdcAcmSubclass,                     // bFunctionSubClass
+        0x00,                               // bFunctionProtocol
+        0x00,                               // iFunction
+
+        /************** Descriptor of CDC communication interface ****************/
+        INTERFACE_DESCRIPTOR_LENGTH,        // bLength
+        INTERFACE_DESCRIPTOR,               // bDescriptorType
+        CdcControlInterface,                // bInterfaceNumber
+        0x00,                               // bAlternateSetting
+        0x01,                               // bNumEndpoints
+        CdcClass,                           // bInterfaceClass
+        CdcAcmSubclass,                     // bInterfaceSubClass
+        0x00,                               // bInterfaceProtocol
+        0x00,                               // iInterface
+
+        5,                                  // bFunctionLength
+        CsInterface,                        // bDescriptorType
+        0x00,                               // bDescriptorSubtype: header
+        LO8(CdcVersion),                    // bcdCDC (LSB)
+        HI8(CdcVersion),                    // bcdCDC (MSB)
+
+        5,                                  // bFunctionLength
+        CsInterface,                        // bDescriptorType
+        0x01,                               // bDescriptorSubtype: call management
+        0x00,                               // bmCapabilities
+        CdcDataInterface,                   // bDataInterface
+
+        4,                                  // bFunctionLength
+        CsInterface,                        // bDescriptorType
+        0x02,                               // bDescriptorSubtype: abstract control management
+        0x02,                               // bmCapabilities: line coding and serial state requests
+
+        5,                                  // bFunctionLength
+        CsInterface,                        // bDescriptorType
+        0x06,                               // bDescriptorSubtype: union
+        CdcControlInterface,                // bControlInterface
+        CdcDataInterface,                   // bSubordinateInterface0
+
+        ENDPOINT_DESCRIPTOR_LENGTH,         // bLength
+        ENDPOINT_DESCRIPTOR,                // bDescriptorType
+        cdcNotificationIn,                  // bEndpointAddress
+        E_INTERRUPT,                        // bmAttributes
+        LO8(CdcNotificationSize),           // wMaxPacketSize (LSB)
+        HI8(CdcNotificationSize),           // wMaxPacketSize (MSB)
+        NotificationInterval,               // bInterval (milliseconds)
+
+        /************** Descriptor of CDC data interface ****************/
+        INTERFACE_DESCRIPTOR_LENGTH,        // bLength
+        INTERFACE_DESCRIPTOR,               // bDescriptorType
+        CdcDataInterface,                   // bInterfaceNumber
+        0x00,                               // bAlternateSetting
+        0x02,                               // bNumEndpoints
+        CdcDataClass,                       // bInterfaceClass
+        0x00,                               // bInterfaceSubClass
+        0x00,                               // bInterfaceProtocol
+        0x00,                               // iInterface
+
+        ENDPOINT_DESCRIPTOR_LENGTH,         // bLength
+        ENDPOINT_DESCRIPTOR,                // bDescriptorType
+        cdcBulkIn,                          // bEndpointAddress
+        E_BULK,                             // bmAttributes
+        LO8(CdcPacketSize),                 // wMaxPacketSize (LSB)
+        HI8(CdcPacketSize),                 // wMaxPacketSize (MSB)
+        0,                                  // bInterval
+
+        ENDPOINT_DESCRIPTOR_LENGTH,         // bLength
+        ENDPOINT_DESCRIPTOR,                // bDescriptorType
+        cdcBulkOut,                         // bEndpointAddress
+        E_BULK,                             // bmAttributes
+        LO8(CdcPacketSize),                 // wMaxPacketSize (LSB)
+        HI8(CdcPacketSize),                 // wMaxPacketSize (MSB)
+        0                                   // bInterval
     };
 
     MBED_ASSERT(sizeof(configurationDescriptorTemp) == sizeof(configurationDescriptor));
@@ -176,35 +350,211 @@ const uint8_t* USBJoystick::string_iproduct_desc()
     return static_cast<const uint8_t*>(OverriddenStringIproductDescriptor);
 }
 
+/*
+ * fills HID joystick report with joystick data
+ */
+void USBJoystick::fillReport(JoystickReportId reportId, const JoystickData& joystickData, HID_REPORT& report)
+{
+    if(reportId == JoystickReportId::Axes)
+    {
+        JoystickAxesReport axesReport{static_cast<uint8_t>(reportId), joystickData.X, joystickData.Y, joystickData.Rz, joystickData.Rx, joystickData.Ry};
+        memcpy(static_cast<void*>(report.data), static_cast<const void*>(&axesReport), sizeof(axesReport));
+        report.length = sizeof(axesReport);
+    }
+    else
+    {
+        JoystickControlsReport controlsReport{static_cast<uint8_t>(reportId), joystickData.Z, joystickData.slider, joystickData.dial, joystickData.hat, joystickData.buttons};
+        memcpy(static_cast<void*>(report.data), static_cast<const void*>(&controlsReport), sizeof(controlsReport));
+        report.length = sizeof(controlsReport);
+    }
+}
+
+/*
+ * store the data of the sent report for the host requests
+ */
+void USBJoystick::storeData(const JoystickData& joystickData)
+{
+    CriticalSectionLock lock;
+    lastData = joystickData;
+}
+
 /*
  * sends HID joystick report to PC
  */
-bool USBJoystick::sendReport(JoystickData& joystickData)
+bool USBJoystick::sendReport(JoystickReportId reportId, const JoystickData& joystickData)
 {
+    storeData(joystickData);
     HID_REPORT report;
-    uint8_t index = 0;
-    report.data[index++] = LO8(joystickData.X);         //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = HI8(joystickData.X);         //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = LO8(joystickData.Y);         //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = HI8(joystickData.Y);         //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = LO8(joystickData.Z);         //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = HI8(joystickData.Z);         //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = LO8(joystickData.Rz);        //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = HI8(joystickData.Rz);        //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = LO8(joystickData.Rx);        //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = HI8(joystickData.Rx);        //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = LO8(joystickData.Ry);        //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = HI8(joystickData.Ry);        //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = LO8(joystickData.slider);    //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = HI8(joystickData.slider);    //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = LO8(joystickData.dial);      //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = HI8(joystickData.dial);      //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = joystickData.hat;            //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    report.data[index++] = joystickData.buttons & 0xFF;                     //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index,hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-magic-numbers)
-    report.data[index++] = (joystickData.buttons >> 8) & 0xFF;              //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index,hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-magic-numbers)
-    report.data[index++] = (joystickData.buttons >> 16) & 0xFF;             //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index,hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-magic-numbers)
-    report.data[index++] = (joystickData.buttons >> 24) & 0xFF;             //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index,hicpp-signed-bitwise,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-magic-numbers)
-
-    report.length = index;
+    fillReport(reportId, joystickData, report);
     return send(&report);
 }
+
+/*
+send report without waiting for the transfer completion
+*/
+bool USBJoystick::sendReportNonBlocking(JoystickReportId reportId, const JoystickData& joystickData)
+{
+    storeData(joystickData);
+    HID_REPORT report;
+    fillReport(reportId, joystickData, report);
+    return send_nb(&report);
+}
+
+/*
+ * handle the CDC requests, the host GET_REPORT request of a joystick input report with the full current state of the report
+ * and the GET_REPORT/SET_REPORT requests of the parameter feature report (USB ISR context)
+ * all other requests are handled by USBHID
+ */
+void USBJoystick::callback_request(const setup_packet_t* setup)
+{
+    if(isCdcRequest(setup))
+    {
+        switch(setup->bRequest)
+        {
+        case CdcSetLineCoding:
+            // the line coding has no effect on the USB transfers; it is stored for the host only
+            complete_request(Receive, cdcLineCoding.data(), cdcLineCoding.size());
+            break;
+        case CdcGetLineCoding:
+            complete_request(Send, cdcLineCoding.data(), cdcLineCoding.size());
+            break;
+        case CdcSetControlLineState:
+            // DTR is set while the host has the port open
+            CdcStream::getInstance().setConnected((setup->wValue & 1U) != 0);
+            complete_request(Success);
+            break;
+        default:
+            complete_request(Failure);
+            break;
+        }
+        return;
+    }
+
+    uint8_t reportType = HI8(setup->wValue);
+    uint8_t reportId = LO8(setup->wValue);
+    if((setup->bmRequestType.Type == CLASS_TYPE) && (setup->wIndex == HidInterface))
+    {
+        if((setup->bRequest == GET_REPORT) && (reportType == InputReportType) &&
+           ((reportId == static_cast<uint8_t>(JoystickReportId::Axes)) || (reportId == static_cast<uint8_t>(JoystickReportId::Controls))))
+        {
+            fillReport(static_cast<JoystickReportId>(reportId), lastData, requestedReport);
+            complete_request(Send, static_cast<uint8_t*>(requestedReport.data), requestedReport.length);
+            return;
+        }
+        if((reportType == FeatureReportType) && (reportId == static_cast<uint8_t>(JoystickReportId::Parameters)) && parameterReadCb && parameterWriteCb)
+        {
+            if(setup->bRequest == GET_REPORT)
+            {
+                parameterReport.reportId = reportId;
+                parameterReadCb(parameterReport.data);
+                complete_request(Send, reinterpret_cast<uint8_t*>(&parameterReport), sizeof(parameterReport));
+                return;
+            }
+            if(setup->bRequest == SET_REPORT)
+            {
+                // the parameters are passed to the owner when the data stage is complete
+                complete_request(Receive, reinterpret_cast<uint8_t*>(&parameterReport), sizeof(parameterReport));
+                return;
+            }
+        }
+    }
+    USBHID::callback_request(setup);
+}
+
+void USBJoystick::callback_request_xfer_done(const setup_packet_t* setup, bool aborted)
+{
+    if(isCdcRequest(setup))
+    {
+        complete_request_xfer_done(!aborted);
+        return;
+    }
+    if((setup->bmRequestType.Type == CLASS_TYPE) && (setup->wIndex == HidInterface) && (setup->bRequest == SET_REPORT) &&
+       (HI8(setup->wValue) == FeatureReportType) && (LO8(setup->wValue) == static_cast<uint8_t>(JoystickReportId::Parameters)))
+    {
+        // the request fails if the owner rejects the parameters
+        complete_request_xfer_done(!aborted && (parameterReport.reportId == LO8(setup->wValue)) && parameterWriteCb(parameterReport.data));
+        return;
+    }
+    USBHID::callback_request_xfer_done(setup, aborted);
+}
+
+/*
+ * add the CDC endpoints; the HID endpoints are added by USBHID (USB ISR context)
+ */
+void USBJoystick::callback_set_configuration(uint8_t configuration)
+{
+    endpoint_add(cdcNotificationIn, CdcNotificationSize, USB_EP_TYPE_INT);
+    endpoint_add(cdcBulkIn, CdcPacketSize, USB_EP_TYPE_BULK, &USBJoystick::onCdcBulkIn);
+    endpoint_add(cdcBulkOut, CdcPacketSize, USB_EP_TYPE_BULK, &USBJoystick::onCdcBulkOut);
+    read_start(cdcBulkOut, cdcReceivePacket.data(), CdcPacketSize);
+    isCdcConfigured = true;
+    isCdcTransmitBusy = false;
+    // the data buffered before the configuration is sent when the host opens the port
+    sendCdcPacket();
+    USBHID::callback_set_configuration(configuration);
+}
+
+void USBJoystick::callback_state_change(DeviceState newState)
+{
+    if(newState != Configured)
+    {
+        isCdcConfigured = false;
+        isCdcTransmitBusy = false;
+        CdcStream::getInstance().setConnected(false);
+    }
+    USBHID::callback_state_change(newState);
+}
+
+bool USBJoystick::isCdcRequest(const setup_packet_t* setup)
+{
+    return (setup->bmRequestType.Type == CLASS_TYPE) && (setup->wIndex == CdcControlInterface);
+}
+
+/*
+ * start sending the buffered CDC data if no transfer is in progress (called after the data is written to the CdcStream)
+ */
+void USBJoystick::startCdcTransmit()
+{
+    lock();
+    if(!isCdcTransmitBusy)
+    {
+        sendCdcPacket();
+    }
+    unlock();
+}
+
+/*
+ * start the transfer of the next packet of the buffered CDC data (USB device locked)
+ */
+void USBJoystick::sendCdcPacket()
+{
+    if(!isCdcConfigured)
+    {
+        return;
+    }
+    uint32_t size = CdcStream::getInstance().takeTransmitData(cdcTransmitPacket.data(), CdcPacketSize);
+    if(size != 0)
+    {
+        isCdcTransmitBusy = write_start(cdcBulkIn, cdcTransmitPacket.data(), size);
+    }
+}
+
+/*
+ * CDC data IN transfer completion (USB ISR context)
+ */
+void USBJoystick::onCdcBulkIn()
+{
+    write_finish(cdcBulkIn);
+    isCdcTransmitBusy = false;
+    sendCdcPacket();
+}
+
+/*
+ * CDC data OUT transfer completion (USB ISR context)
+ */
+void USBJoystick::onCdcBulkOut()
+{
+    uint32_t size = read_finish(cdcBulkOut);
+    CdcStream::getInstance().storeReceivedData(cdcReceivePacket.data(), size);
+    read_start(cdcBulkOut, cdcReceivePacket.data(), CdcPacketSize);
+}
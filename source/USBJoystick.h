@@ -10,6 +10,7 @@
 
 #include "USBHID.h"
 #include <mbed.h>
+#include <array>
 
 struct JoystickData     //NOLINT(altera-struct-pack-align)
 {
@@ -25,6 +26,51 @@ struct JoystickData     //NOLINT(altera-struct-pack-align)
     uint32_t buttons;
 };
 
+// HID input reports of the joystick
+enum struct JoystickReportId : uint8_t
+{
+    Axes = 1,           // IMU axes, sent at the IMU frame rate
+    Controls = 2,       // potentiometer axes, HAT switch and buttons, sent on change
+    Parameters = 3      // feature report of the tunable parameters
+};
+
+constexpr size_t JoystickParameterDataSize = 32;    // size of the parameter data in the feature report [bytes]
+using JoystickParameterData = std::array<uint8_t, JoystickParameterDataSize>;
+
+// the report structures are packed in the order of the report fields, so a report is a copy of its structure
+MBED_PACKED(struct) JoystickAxesReport     //NOLINT(altera-struct-pack-align)
+{
+    uint8_t reportId;
+    int16_t X;
+    int16_t Y;
+    int16_t Rz;
+    int16_t Rx;
+    int16_t Ry;
+};
+
+MBED_PACKED(struct) JoystickControlsReport     //NOLINT(altera-struct-pack-align)
+{
+    uint8_t reportId;
+    int16_t Z;
+    int16_t slider;
+    int16_t dial;
+    uint8_t hat;            // HAT switch position in the low nibble
+    uint32_t buttons;
+};
+
+// feature report of the yoke parameters
+MBED_PACKED(struct) JoystickParameterReport     //NOLINT(altera-struct-pack-align)
+{
+    uint8_t reportId;
+    JoystickParameterData data;
+};
+
+/*
+USB composite device of the HID joystick and the CDC-ACM serial port
+the HID joystick is interface 0 with the endpoints of USBHID; the CDC-ACM interfaces 1 and 2 carry the CdcStream data
+the joystick has the input reports of the JoystickReportId and the parameter feature report, which the host reads and writes
+with the GET_REPORT and SET_REPORT requests
+*/
 class USBJoystick : public USBHID
 {
 public:
@@ -35,13 +81,52 @@ public:
     void operator=(USBJoystick&&) = delete;
      ~USBJoystick() override;
     const uint8_t* report_desc() override; // returns pointer to the report descriptor; Warning: this method must store the length of the report descriptor in reportLength
-    bool sendReport(JoystickData& joystickData);
+    bool sendReport(JoystickReportId reportId, const JoystickData& joystickData);
+    bool sendReportNonBlocking(JoystickReportId reportId, const JoystickData& joystickData);     // returns false if the previous report has not been sent yet
+    // callbacks of the parameter feature report, called in the USB interrupt context; the write callback returns false to reject the data
+    void setParameterCallbacks(Callback<void(JoystickParameterData&)> readCb, Callback<bool(const JoystickParameterData&)> writeCb)
+    {
+        parameterReadCb = readCb;
+        parameterWriteCb = writeCb;
+    }
 protected:
+    void callback_state_change(DeviceState newState) override;
+    void callback_request(const setup_packet_t* setup) override;
+    void callback_request_xfer_done(const setup_packet_t* setup, bool aborted) override;
+    void callback_set_configuration(uint8_t configuration) override;
+    const uint8_t* device_desc() override;      // Get device descriptor of the composite device
     const uint8_t* configuration_desc(uint8_t index) override;   // Get configuration descriptor; returns pointer to the configuration descriptor
     const uint8_t* string_iproduct_desc() override;      // Get string product descriptor
 private:
-    static constexpr size_t ConfigurationDescriptorSize = 41U;
+    static void fillReport(JoystickReportId reportId, const JoystickData& joystickData, HID_REPORT& report);
+    void storeData(const JoystickData& joystickData);
+    JoystickData lastData{0};           // joystick data of the last sent report; returned on the host GET_REPORT request
+    HID_REPORT requestedReport{0};      // report returned on the host GET_REPORT request
+    JoystickParameterReport parameterReport{0};     // feature report of the host GET_REPORT and SET_REPORT requests
+    Callback<void(JoystickParameterData&)> parameterReadCb{nullptr};
+    Callback<bool(const JoystickParameterData&)> parameterWriteCb{nullptr};
+    static bool isCdcRequest(const setup_packet_t* setup);
+    void startCdcTransmit();
+    void sendCdcPacket();
+    void onCdcBulkIn();
+    void onCdcBulkOut();
+    static constexpr size_t ConfigurationDescriptorSize = 107U;
     uint8_t configurationDescriptor[ConfigurationDescriptorSize]{0};        //NOLINT(hicpp-avoid-c-arrays,modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+    static constexpr size_t DeviceDescriptorSize = 18U;
+    uint8_t deviceDescriptor[DeviceDescriptorSize]{0};      //NOLINT(hicpp-avoid-c-arrays,modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+    uint16_t vendorId;
+    uint16_t productId;
+    uint16_t productRelease;
+    static constexpr uint32_t CdcPacketSize = 64U;          // maximum packet size of the CDC bulk endpoints
+    static constexpr uint32_t CdcNotificationSize = 16U;    // maximum packet size of the CDC notification endpoint
+    usb_ep_t cdcNotificationIn{0};      // CDC interrupt IN endpoint; no notifications are sent
+    usb_ep_t cdcBulkIn{0};              // CDC data IN endpoint
+    usb_ep_t cdcBulkOut{0};             // CDC data OUT endpoint
+    std::array<uint8_t, CdcPacketSize> cdcTransmitPacket{};
+    std::array<uint8_t, CdcPacketSize> cdcReceivePacket{};
+    std::array<uint8_t, 7> cdcLineCoding{0x00, 0xC2, 0x01, 0x00, 0x00, 0x00, 0x08};     // 115200 baud, 1 stop bit, no parity, 8 data bits     NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    bool isCdcConfigured{false};        // the CDC endpoints are configured
+    bool isCdcTransmitBusy{false};      // a CDC IN transfer is in progress
 };
 
 #endif /* USBJOYSTICK_H_ */
\ No newline at end of file
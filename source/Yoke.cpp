@@ -1,10 +1,13 @@
 #include "Yoke.h"
 #include "Alarm.h"
+#include "ButtonMap.h"
+#include "Debouncer.h"
 #include "Convert.h"
 #include "Display.h"
 #include "Logger.h"
 #include "Menu.h"
 #include "Storage.h"
+#include <algorithm>
 #include <iomanip>
 
 //XXX global variables for test
@@ -13,36 +16,57 @@ float g_accX, g_accY, g_accZ;       //NOLINT(cppcoreguidelines-avoid-non-const-g
 float g_magX, g_magY, g_magZ;       //NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 float g_sensorPitch, g_sensorRoll, g_sensorYaw;     //NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
-Yoke::Yoke(events::EventQueue& eventQueue) :
-    eventQueue(eventQueue),
+// GPIO pins of the switch inputs in the SwitchInput order, followed by the HAT switch pins north, east, south, west
+constexpr size_t NumberOfSwitches = static_cast<size_t>(SwitchInput::Size);
+constexpr size_t NumberOfHatPins = 4;
+constexpr std::array<PinName, NumberOfSwitches + NumberOfHatPins> InputPins
+{
+    PE_3, PE_4, PF_4, PF_5, PG_0, PB_2, PG_15, PE_1, PE_6, PG_3, PG_2, PF_9, PF_8, PB_13,
+    PG_13, PG_9, PG_12, PG_10
+};
+
+// joystick buttons of the switch inputs; all switches are active low
+constexpr uint8_t switchBit(SwitchInput input) { return static_cast<uint8_t>(input); }
+constexpr std::array<ButtonMapping, 10> SwitchButtonMap     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+{{
+    {switchBit(SwitchInput::FlapsUp), 0, true},
+    {switchBit(SwitchInput::FlapsDown), 1, true},
+    {switchBit(SwitchInput::GearUp), 2, true},
+    {switchBit(SwitchInput::GearDown), 3, true},
+    {switchBit(SwitchInput::RedPushbutton), 4, true},
+    {switchBit(SwitchInput::GreenPushbutton), 5, true},     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    {switchBit(SwitchInput::Set), 11, true},                //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    {switchBit(SwitchInput::Reset), 12, true},              //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    {switchBit(SwitchInput::Reverser), 13, true},           //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    {switchBit(SwitchInput::SpeedBrake), 14, true}          //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+}};
+constexpr auto SwitchButtonTable = makeButtonMapTable(SwitchButtonMap);
+
+// joystick buttons of the HAT positions in the trim mode: elevator trim down (N), rudder trim right (E), elevator trim up (S), rudder trim left (W)
+constexpr std::array<uint32_t, 9> TrimButtons{0, 1U << 6, 0, 1U << 8, 0, 1U << 7, 0, 1U << 9, 0};     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+// statically allocated stack of the IMU thread
+constexpr uint32_t ImuThreadStackSize = 4096;
+MBED_ALIGN(8) static std::array<unsigned char, ImuThreadStackSize> imuThreadStack;     //NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+Yoke::Yoke() :
+    imuThread(osPriority_t::osPriorityHigh, ImuThreadStackSize, imuThreadStack.data(), "IMU"),
     systemLed(LED2),
     usbJoystick(USB_VID, USB_PID, USB_VER),
     imuInterruptSignal(LSM9DS1_INT1, PullDown),
     i2cBus(I2C2_SDA, I2C2_SCL),
     sensorGA(i2cBus, LSM9DS1_AG_ADD),
     sensorM(i2cBus, LSM9DS1_M_ADD),
+    imuAcquisition(imuThread, sensorGA, sensorM),
+    profiler({"I2C acquisition", "fusion", "axis scaling", "buttons", "USB report", "calibration"}),
+    reportFilter(MBED_CONF_APP_USB_REPORT_DEADBAND, std::chrono::milliseconds(MBED_CONF_APP_USB_REPORT_KEEP_ALIVE)),
+#if MBED_CONF_APP_FIXED_POINT_PIPELINE
+    fixedPointFusion(AngularRateResolution, ImuSamplePeriod, 0.42F),      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+#else
+    orientationFilter(0.42F),       //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+#endif
     calibrationLed(LED1, 0),
-    flapsUpSwitch(PE_3, PullUp),
-    flapsDownSwitch(PE_4, PullUp),
-    gearUpSwitch(PF_4, PullUp),
-    gearDownSwitch(PF_5, PullUp),
-    redPushbutton(PG_0, PullUp),
-    greenPushbutton(PB_2, PullUp),
-    hatCenterSwitch(PG_15, PullUp),
-    setSwitch(PE_1, PullUp),
-    resetSwitch(PE_6, PullUp),
-    reverserSwitch(PG_3, PullUp),
-    speedBrakeSwitch(PG_2, PullUp),
-    hatModeToggle(PF_9, PullUp),
-    viewModeToggle(PF_8, PullUp),
-    hatModeShift(PB_13, PullUp),
-    throttlePotentiometer(PA_0),
-    propellerPotentiometer(PA_4),
-    mixturePotentiometer(PA_1),
-    orangePotentiometer(PC_0),
-    yellowPotentiometer(PC_1),
-    blueGrayPotentiometer(PA_5),
-    hatSwitch(PG_13, PG_9, PG_12, PG_10),
+    potentiometers({PA_0, PA_4, PA_1, PC_0, PC_1, PA_5}),
     joystickGainFilter(0.01F)       //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 {
     LOG_INFO("Yoke object created");
@@ -50,18 +74,30 @@ Yoke::Yoke(events::EventQueue& eventQueue) :
     constexpr int I2CBusFreq = 400000;
     i2cBus.frequency(I2CBusFreq);
 
-    // connect USB joystick
+    // debounce the switch and HAT inputs
+    Debouncer::getInstance().addPins(InputPins, PullUp);
+
+    // start the background acquisition of the potentiometers
+    potentiometers.start();
+
+    // connect USB joystick with the host access to the yoke parameters
+    usbJoystick.setParameterCallbacks(callback(this, &Yoke::readParameters), callback(this, &Yoke::writeParameters));
     usbJoystick.connect();
 
     // configure IMU sensor
-    // Gyroscope ODR=119 Hz, full scale 500 dps
+    // Gyroscope ODR=476 Hz, full scale 500 dps
     // int/out selection default
-    // low power disable, HPF enable, HPF=0.05 Hz
-    sensorGA.write(static_cast<uint8_t>(LSM9DS1reg::CTRL_REG1_G), std::vector<uint8_t>{0x68, 0x00, 0x47});      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-    // Accelerometer ODR=119 Hz, full scale +=2g
-    sensorGA.write(static_cast<uint8_t>(LSM9DS1reg::CTRL_REG6_XL), std::vector<uint8_t>{0x60});     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-    // INT1<-DRDY_G
-    sensorGA.write(static_cast<uint8_t>(LSM9DS1reg::INT1_CTRL), std::vector<uint8_t>{0x02});        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    // low power disable, HPF enable, HPCF=7 (cut-off frequency scales with ODR)
+    sensorGA.write(static_cast<uint8_t>(LSM9DS1reg::CTRL_REG1_G), std::vector<uint8_t>{0xA8, 0x00, 0x47});      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    // Accelerometer ODR=476 Hz, full scale +=2g
+    sensorGA.write(static_cast<uint8_t>(LSM9DS1reg::CTRL_REG6_XL), std::vector<uint8_t>{0xA0});     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    // FIFO enable
+    sensorGA.write(static_cast<uint8_t>(LSM9DS1reg::CTRL_REG9), std::vector<uint8_t>{0x02});        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    // FIFO continuous mode, threshold level for the watermark interrupt
+    constexpr uint8_t FifoContinuousMode = 0xC0U;
+    sensorGA.write(static_cast<uint8_t>(LSM9DS1reg::FIFO_CTRL), std::vector<uint8_t>{static_cast<uint8_t>(FifoContinuousMode | ImuFifoThreshold)});
+    // INT1<-FIFO threshold
+    sensorGA.write(static_cast<uint8_t>(LSM9DS1reg::INT1_CTRL), std::vector<uint8_t>{0x08});        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 
     // configure magnetometer sensor
     // Magnetometer X&Y high-performance mode, ODR=80 Hz
@@ -80,19 +116,33 @@ Yoke::Yoke(events::EventQueue& eventQueue) :
     sensorPitchReference = KvStore::getInstance().restore<float>("/kv/sensorPitchRef", 0.0F, -0.5F, 0.5F);      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     sensorRollReference = KvStore::getInstance().restore<float>("/kv/sensorRollRef", 0.0F, -0.5F, 0.5F);        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     sensorYawReference = KvStore::getInstance().restore<float>("/kv/sensorYawRef", 0.0F, -0.5F, 0.5F);          //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+#if MBED_CONF_APP_FIXED_POINT_PIPELINE
+    sensorAngleReference = {toBinaryAngle(sensorRollReference), toBinaryAngle(sensorPitchReference), toBinaryAngle(sensorYawReference)};
+#endif
 
-    // call handler on IMU interrupt rise signal
+    // start IMU data acquisition on IMU interrupt rise signal
+    // handler is called in the IMU thread when the acquired frame is complete
+    imuAcquisition.setCallback(callback(this, &Yoke::handler));
+    recorder.setReplayCallback(callback(this, &Yoke::resetProcessing));
+    imuThread.start(callback(this, &Yoke::imuThreadHandler));
     imuInterruptSignal.rise(callback(this, &Yoke::imuInterruptHandler));
+#if MBED_CONF_APP_USB_REPORT_SCHEDULER
+    // send USB reports at the USB endpoint poll rate
+    constexpr std::chrono::microseconds ReportPeriod = 1ms;
+    reportTicker.attach(callback(this, &Yoke::reportTickerHandler), ReportPeriod);
+#endif
     // this timeout calls handler for the first time
     // next calls will be executed upon IMU INT1 interrupt signal
     constexpr std::chrono::milliseconds HandlerDelay = 100ms;
-    imuIntTimeout.attach(callback(this, &Yoke::imuInterruptHandler), HandlerDelay);
+    imuIntTimeout.attach(callback(this, &Yoke::imuTimeoutHandler), HandlerDelay);
 
     // start handler timer
     handlerTimer.start();
 
     // register console commands
     Console::getInstance().registerCommand("ys", "display yoke status", callback(this, &Yoke::displayStatus));
+    Console::getInstance().registerCommand("yp", "display and reset yoke handler profile", callback(this, &Yoke::displayProfile));
+    Console::getInstance().registerCommand("yl", "display and reset IMU to USB report latency", callback(this, &Yoke::displayLatency));
 
     // add menu items
     Menu::getInstance().addItem("calibrate", callback(this, &Yoke::toggleAxisCalibration));
@@ -102,28 +152,86 @@ Yoke::Yoke(events::EventQueue& eventQueue) :
 
 
 /*
-* yoke handler is called on IMU interrupt signal
+* called when no IMU interrupt rise signal has come in time
+*/
+void Yoke::imuTimeoutHandler()
+{
+    if(imuAcquisition.isAcquiring())
+    {
+        // the frame transfer has been lost - the acquisition aborts and re-issues it
+        imuAcquisition.abort();
+    }
+    else if(imuInterruptSignal.read() == 1)
+    {
+        // data is ready, but the rising edge has been missed
+        imuAcquisition.start();
+    }
+    else
+    {
+        // no interrupt signal - handler will report the missing frame
+        imuThread.flags_set(NoImuInterruptFlag);
+    }
+}
+
+/*
+* IMU thread waits for the thread flags set by the IMU interrupt, I2C transfer callbacks and the IMU timeout
+* no event memory is allocated on the way from the interrupt to the handler
+*/
+void Yoke::imuThreadHandler()
+{
+    while(true)
+    {
+        uint32_t flags = ThisThread::flags_wait_any(ImuAcquisition::AllFlags | NoImuInterruptFlag | ReportFlag);
+        imuAcquisition.processFlags(flags);
+        if((flags & NoImuInterruptFlag) != 0)
+        {
+            handler();
+        }
+        if((flags & ReportFlag) != 0)
+        {
+            sendScheduledReport();
+        }
+    }
+}
+
+/*
+* yoke handler is called when the IMU frame acquired upon IMU interrupt signal is complete
 */
 void Yoke::handler()
 {
+    profiler.start();
+
     // this timeout is set only for the case of lost IMU interrupt signal
     // the timeout should never happen, as the next interrupt should be called earlier
     constexpr std::chrono::milliseconds NoIntTimeout = 20ms;
-    imuIntTimeout.attach(callback(this, &Yoke::imuInterruptHandler), NoIntTimeout);
+    imuIntTimeout.attach(callback(this, &Yoke::imuTimeoutHandler), NoIntTimeout);
 
-    // measure time elapsed since the previous call [s]
-    float deltaT = std::chrono::duration<float>(handlerTimer.elapsed_time()).count();
-    handlerTimer.reset();
     counter++;
 
+    // parameters written by the host are applied between the handler calls only
+    if(core_util_atomic_load_bool(&isParameterUpdatePending))
+    {
+        applyParameters();
+    }
+
+    ImuFrame imuFrame;
+    bool isFrameReceived = imuAcquisition.getFrame(imuFrame);
+    YokeInputs inputs{};
+    readInputs(inputs);
+    // the recorder stores or replaces the data of the received frames only
+    if(isFrameReceived && !recorder.replay(imuFrame, inputs))
+    {
+        recorder.record(imuFrame, inputs);
+    }
+
     // set HAT switch mode
-    if((hatModeToggle.read() ^ hatModeShift.read()) == 0)       //NOLINT(hicpp-signed-bitwise)
+    if((getLevel(inputs, SwitchInput::HatModeToggle) ^ getLevel(inputs, SwitchInput::HatModeShift)) == 0)       //NOLINT(hicpp-signed-bitwise)
     {
         // HAT mode shift pressed in HAT view mode or
         // HAT mode shift NOT pressed in HAT trim mode
         hatMode = HatSwitchMode::TrimMode;
     }
-    else if(viewModeToggle.read() != 0)      // hat view mode toggle down
+    else if(getLevel(inputs, SwitchInput::ViewModeToggle) != 0)      // hat view mode toggle down
     {
         hatMode = HatSwitchMode::QuickViewMode;
     }
@@ -133,71 +241,304 @@ void Yoke::handler()
     }
 
     // set brake mode from RESET pushbutton
-    bool brakeActive = (resetSwitch.read() == 0);
-
-    std::vector<uint8_t> sensorData;
-    if(imuInterruptSignal.read() == 1)
-    {
-        // interrupt signal is active
-        // read IMU sensor data
-        sensorData = sensorGA.read(static_cast<uint8_t>(LSM9DS1reg::OUT_X_L_G), 12);    //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-        gyroscopeData.X = *reinterpret_cast<int16_t*>(&sensorData[4]);
-        gyroscopeData.Y = *reinterpret_cast<int16_t*>(&sensorData[2]);
-        gyroscopeData.Z = *reinterpret_cast<int16_t*>(&sensorData[0]);
-        accelerometerData.X = *reinterpret_cast<int16_t*>(&sensorData[10]);     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-        accelerometerData.Y = *reinterpret_cast<int16_t*>(&sensorData[8]);      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-        accelerometerData.Z = *reinterpret_cast<int16_t*>(&sensorData[6]);      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-
-        // read magnetometer data
-        sensorData = sensorM.read(static_cast<uint8_t>(LSM9DS1reg::OUT_X_L_M), 6);      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-        magnetometerData.X = *reinterpret_cast<int16_t*>(&sensorData[0]);
-        magnetometerData.Y = *reinterpret_cast<int16_t*>(&sensorData[2]);
-        magnetometerData.Z = *reinterpret_cast<int16_t*>(&sensorData[4]);
+    bool brakeActive = (getLevel(inputs, SwitchInput::Reset) == 0);
+
+    uint8_t sampleCount{0};
+    bool isMagnetometerFresh{false};
+    if(isFrameReceived)
+    {
+        if(imuFrame.isValid)
+        {
+            sampleCount = imuFrame.sampleCount;
+            profiler.add(HandlerStage::Acquisition, imuFrame.completionTime - imuFrame.interruptTime);
+
+            // parse magnetometer data only when the magnetometer has produced a new sample
+            isMagnetometerFresh = imuFrame.isMagnetometerFresh;
+            if(isMagnetometerFresh)
+            {
+                parseMagnetometerSample(imuFrame.magnetometerData.data(), magnetometerData);
+            }
+        }
+        else
+        {
+            // at least one of the frame transfers has failed or has been aborted
+            Alarm::getInstance().set(AlarmID::ImuTransfer);
+        }
     }
     else
     {
         // no interrupt signal
         Alarm::getInstance().set(AlarmID::NoImuInterrupt);
+        latencyMonitor.addMissed();
+    }
+
+    // calculate joystick axes gain
+    joystickGainFilter.calculate(getPotentiometer(inputs, Potentiometer::BlueGray) + 0.5F);  // range 0.5 .. 1.5     NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    // calculate joystick pitch, roll and yaw axes and brakes from the IMU sensor data
+    calculateImuAxes(imuFrame, sampleCount, isMagnetometerFresh, inputs.deltaT, brakeActive);
+
+#if MBED_CONF_APP_THROTTLE_FILTER_CUTOFF
+    throttleInput = filterThrottle(getPotentiometer(inputs, Potentiometer::Throttle), inputs.deltaT);
+#else
+    throttleFilter.calculate(getPotentiometer(inputs, Potentiometer::Throttle));
+    throttleInput = throttleFilter.getValue();
+#endif
+    const float ThrottleDeadZone = 0.03F;
+    joystickData.slider = scale<float, int16_t>(throttleInputMin + ThrottleDeadZone, throttleInputMax - ThrottleDeadZone, throttleInput, 0, Max15bit);
+
+    propellerFilter.calculate(getPotentiometer(inputs, Potentiometer::Propeller));
+    joystickData.dial = scale<float, int16_t>(0.0F, 1.0F, propellerFilter.getValue(), 0, Max15bit);
+
+    mixtureFilter.calculate(getPotentiometer(inputs, Potentiometer::Mixture));
+    joystickData.Z = scale<float, int16_t>(0.0F, 1.0F, mixtureFilter.getValue(), -Max15bit, Max15bit);
+
+    profiler.mark(HandlerStage::AxisScaling);
+
+    // set joystick buttons
+    setJoystickButtons(inputs);
+    profiler.mark(HandlerStage::Buttons);
+
+#if MBED_CONF_APP_USB_REPORT_SCHEDULER
+    // the report is sent by the report scheduler
+    if(isFrameReceived)
+    {
+        reportInterruptTime = imuFrame.interruptTime;
+        reportCompletionTime = imuFrame.completionTime;
+        reportDispatchTime = profiler.getStartTime();
+        isNewReportData = true;
+    }
+    profiler.mark(HandlerStage::Report);
+#else
+    // the IMU axes report is due on every move; the controls report only on a change of the controls
+    // one report is passed to the USB device per handler call without waiting for the transfer
+    JoystickData report = joystickData;
+    JoystickReportId reportId{JoystickReportId::Axes};
+    bool isAxesReportSent = sendDueReport(report, reportId) && (reportId == JoystickReportId::Axes);
+    profiler.mark(HandlerStage::Report);
+    if(isFrameReceived && isAxesReportSent)
+    {
+        // the age of the IMU data when the report has been passed to the USB device
+        latencyMonitor.add(imuFrame.interruptTime, imuFrame.completionTime, profiler.getStartTime(), getCycleCount());
+    }
+#endif
+
+    // analog axis calibration on user request
+    axisCalibration();
+    profiler.mark(HandlerStage::Calibration);
+
+    // LED heartbeat
+    constexpr uint32_t HeartbeatMask = 0x68U;
+    systemLed = (counter & HeartbeatMask) == HeartbeatMask ? 1U : 0;
+
+    profiler.stop();
+
+    if((ThisThread::flags_get() & ImuAcquisition::StartFlag) != 0)
+    {
+        // the next IMU interrupt has come before the handler completed
+        handlerOverruns++;
+    }
+}
+
+/*
+* read all yoke inputs of this handler call
+*/
+void Yoke::readInputs(YokeInputs& inputs)
+{
+    // measure time elapsed since the previous call [s]
+    inputs.deltaT = std::chrono::duration<float>(handlerTimer.elapsed_time()).count();
+    handlerTimer.reset();
+
+    // the latest averaged values of the background acquisition
+    potentiometers.read(inputs.potentiometers);
+
+    // debounced levels of all switches
+    PortLevels levels;
+    Debouncer::getInstance().getLevels(levels);
+    inputs.switches = 0;
+    for(size_t index = 0; index < NumberOfSwitches; index++)
+    {
+        inputs.switches |= static_cast<uint16_t>(getPinLevel(levels, InputPins[index]) << index);
+    }
+    uint8_t hatBusValue{0};
+    for(size_t index = 0; index < NumberOfHatPins; index++)
+    {
+        hatBusValue |= static_cast<uint8_t>(getPinLevel(levels, InputPins[NumberOfSwitches + index]) << index);
+    }
+    inputs.hatPosition = Hat::decodePosition(hatBusValue);
+}
+
+#if MBED_CONF_APP_FIXED_POINT_PIPELINE
+/*
+* calculate IMU sensor orientation and joystick axes using fixed-point arithmetic
+* raw sensor data are processed with integer operations only, the angles are binary angles
+*/
+void Yoke::calculateImuAxes(const ImuFrame& imuFrame, uint8_t sampleCount, bool isMagnetometerFresh, float deltaT, bool brakeActive)
+{
+    if(isMagnetometerFresh)
+    {
+        // calculate yaw from magnetometer; atan2 +- PI is obtained by the binary angle wrap-around
+        constexpr int32_t MagnetometerYawGain = toQ31(-0.1F * PI);
+        int32_t magnetometerYaw = multiplyQ31(addAngles(fixedAtan2(magnetometerData.Z, magnetometerData.X), std::numeric_limits<int32_t>::min()), MagnetometerYawGain);
+
+        fixedPointFusion.setYawReference(magnetometerYaw);
+    }
+
+    // store sensor values for calculation of deviation
+    Vector3D<int32_t> previousSensorAngle = sensorAngle;
+
+    // integrate all gyroscope and accelerometer samples drained from the IMU FIFO
+    for(uint8_t sample = 0; sample < sampleCount; sample++)
+    {
+        const uint8_t* sampleData = imuFrame.getSample(sample);
+        // parse IMU sensor data
+        parseImuSample(sampleData, gyroscopeData, accelerometerData);
+
+        // map raw sensor data to the body axes; the same mapping as in the floating-point path
+        Vector3D<int16_t> bodyAngularRate{saturatedNegate(gyroscopeData.Y), saturatedNegate(gyroscopeData.Z), gyroscopeData.X};
+        Vector3D<int16_t> bodyAcceleration{accelerometerData.Z, saturatedNegate(accelerometerData.Y), saturatedNegate(accelerometerData.X)};
+
+        fixedPointFusion.update(bodyAngularRate, bodyAcceleration);
+    }
+
+    sensorAngle.X = fixedPointFusion.getRoll();
+    sensorAngle.Y = fixedPointFusion.getPitch();
+    sensorAngle.Z = fixedPointFusion.getYaw();
+    profiler.mark(HandlerStage::Fusion);
+
+    // calculate sensor pitch, roll and yaw variability as filtered angle change per handler call
+    constexpr int32_t VariabilityFilterFactor = toQ31(0.01F);
+    auto filterVariability = [&](int32_t variability, int32_t angle, int32_t previousAngle)
+    {
+        int32_t change = subtractAngles(angle, previousAngle);
+        change = (change < 0) ? saturatedNegate(change) : change;
+        return addAngles(variability, multiplyQ31(subtractAngles(change, variability), VariabilityFilterFactor));
+    };
+    sensorAngleVariability.X = filterVariability(sensorAngleVariability.X, sensorAngle.X, previousSensorAngle.X);
+    sensorAngleVariability.Y = filterVariability(sensorAngleVariability.Y, sensorAngle.Y, previousSensorAngle.Y);
+    sensorAngleVariability.Z = filterVariability(sensorAngleVariability.Z, sensorAngle.Z, previousSensorAngle.Z);
+
+    // store sensor pitch, roll and yaw reference values
+    // the variability threshold [rad/s] is converted to the angle change per handler call once per frame
+    constexpr float SensorVariabilityThreshold = 0.0025F;
+    int32_t variabilityThreshold = toBinaryAngle(SensorVariabilityThreshold * deltaT);
+    if((sensorAngleVariability.X < variabilityThreshold) &&
+       (sensorAngleVariability.Y < variabilityThreshold) &&
+       (sensorAngleVariability.Z < variabilityThreshold))
+    {
+        sensorAngleReference = sensorAngle;
+        calibrationLed = 1;
+    }
+    else
+    {
+        calibrationLed = 0;
+    }
+
+    // calculate sensor calibrated values
+    int32_t calibratedSensorPitch = subtractAngles(sensorAngle.Y, sensorAngleReference.Y);
+    int32_t calibratedSensorRoll = subtractAngles(sensorAngle.X, sensorAngleReference.X);
+    int32_t calibratedSensorYaw = subtractAngles(sensorAngle.Z, sensorAngleReference.Z);
+
+    // calculate joystick pitch and roll depending on the joystick yaw
+    int16_t sinYaw{0};
+    int16_t cosYaw{0};
+    fixedPointFusion.getYawSinCos(sinYaw, cosYaw);
+    auto sin2yaw = static_cast<int16_t>(multiplyQ15(sinYaw, (sinYaw < 0) ? saturatedNegate(sinYaw) : sinYaw));
+    auto cos2yaw = static_cast<int16_t>(multiplyQ15(cosYaw, (cosYaw < 0) ? saturatedNegate(cosYaw) : cosYaw));
+
+    int32_t joystickPitch = addAngles(multiplyQ15(calibratedSensorPitch, cos2yaw), multiplyQ15(calibratedSensorRoll, sin2yaw));
+    int32_t joystickRoll = subtractAngles(multiplyQ15(calibratedSensorRoll, cos2yaw), multiplyQ15(calibratedSensorPitch, sin2yaw));
+    int32_t joystickYaw = calibratedSensorYaw;
+
+    // joystick axes gain in the range 0.5 .. 1.5 applied to the axis scale factors
+    constexpr int GainShift = 14;
+    auto gain = static_cast<int32_t>(joystickGainFilter.getValue() * static_cast<float>(1 << GainShift));
+    auto gainedScale = [gain](int32_t scale)
+    {
+        return static_cast<int32_t>((static_cast<int64_t>(scale) * gain) >> GainShift);      //NOLINT(hicpp-signed-bitwise)
+    };
+
+    // scale joystick axes to USB joystick report range
+    constexpr int32_t BrakeScale = axisScale(1.0F);     // full brake at 1 rad
+    if(brakeActive)
+    {
+        // both brakes from joystick deflected forward
+        int32_t forwardBrake = 2 * scaleAngle(saturatedNegate(joystickPitch), BrakeScale, 0, Max15bit);
+        // left and right brakes from joystick deflected sideways
+        joystickData.Rx = saturate16(std::min<int32_t>(forwardBrake + scaleAngle(saturatedNegate(joystickRoll), BrakeScale, 0, Max15bit), Max15bit));
+        joystickData.Ry = saturate16(std::min<int32_t>(forwardBrake + scaleAngle(joystickRoll, BrakeScale, 0, Max15bit), Max15bit));
     }
+    else
+    {
+        // update pitch axis when not braking only
+        joystickData.Y = scaleAngle(joystickPitch, gainedScale(axisScale(maxAngleY)), -Max15bit, Max15bit);
+        // release brakes
+        joystickData.Rx = 0;
+        joystickData.Ry = 0;
+    }
+    joystickData.X = scaleAngle(joystickRoll, gainedScale(axisScale(maxAngleX)), -Max15bit, Max15bit);
+    joystickData.Rz = scaleAngle(joystickYaw, gainedScale(axisScale(maxAngleZ)), -Max15bit, Max15bit);
 
-    // calculate IMU sensor physical values; using right hand rule
-    // X = roll axis = pointing North
-    // Y = pitch axis = pointing East
-    // Z = yaw axis = pointing down
-    // angular rate in rad/s
-    angularRate.X = -AngularRateResolution * static_cast<float>(gyroscopeData.Y);
-    angularRate.Y = -AngularRateResolution * static_cast<float>(gyroscopeData.Z);
-    angularRate.Z = AngularRateResolution * static_cast<float>(gyroscopeData.X);
-    // acceleration in g
-    acceleration.X = AccelerationResolution * static_cast<float>(accelerometerData.Z);
-    acceleration.Y = -AccelerationResolution * static_cast<float>(accelerometerData.Y);
-    acceleration.Z = -AccelerationResolution * static_cast<float>(accelerometerData.X);
-    // magnetic field in gauss
-    magneticField.X = MagneticFieldResolution * static_cast<float>(magnetometerData.X);
-    magneticField.Y = MagneticFieldResolution * static_cast<float>(magnetometerData.Y);
-    magneticField.Z = MagneticFieldResolution * static_cast<float>(magnetometerData.Z);
-
-    float accelerationXZ = sqrt(acceleration.X * acceleration.X + acceleration.Z * acceleration.Z);
-    float accelerationYZ = sqrt(acceleration.Y * acceleration.Y + acceleration.Z * acceleration.Z);
-
-    // calculate pitch and roll from accelerometer itself [rad]
-    float accelerometerPitch = atan2(acceleration.Y, accelerationXZ);
-    float accelerometerRoll = atan2(acceleration.X, accelerationYZ);
-
-    // calculate yaw from magnetometer  [rad]
-    constexpr float MagnetometerYawGain = -0.1F;
-    float magnetometerYaw = MagnetometerYawGain * PI * (atan2(magneticField.Z, magneticField.X) + (magneticField.Z >= 0.0F ? -PI : PI));
+#if MBED_CONF_APP_USB_REPORT_EXTRAPOLATION
+    // angular rate of the last sample in the body axes
+    Vector3D<float> bodyAngularRate{-AngularRateResolution * static_cast<float>(gyroscopeData.Y),
+                                    -AngularRateResolution * static_cast<float>(gyroscopeData.Z),
+                                    AngularRateResolution * static_cast<float>(gyroscopeData.X)};
+    setAxisRates(bodyAngularRate, static_cast<float>(sin2yaw) / Q15Scale, static_cast<float>(cos2yaw) / Q15Scale, brakeActive);
+#endif
+}
+#else
+/*
+* calculate IMU sensor orientation and joystick axes using floating-point arithmetic
+*/
+void Yoke::calculateImuAxes(const ImuFrame& imuFrame, uint8_t sampleCount, bool isMagnetometerFresh, float deltaT, bool brakeActive)
+{
+    if(isMagnetometerFresh)
+    {
+        // magnetic field in gauss
+        magneticField.X = MagneticFieldResolution * static_cast<float>(magnetometerData.X);
+        magneticField.Y = MagneticFieldResolution * static_cast<float>(magnetometerData.Y);
+        magneticField.Z = MagneticFieldResolution * static_cast<float>(magnetometerData.Z);
+
+        // calculate yaw from magnetometer  [rad]
+        constexpr float MagnetometerYawGain = -0.1F;
+        float magnetometerYaw = MagnetometerYawGain * PI * (fastAtan2(magneticField.Z, magneticField.X) + (magneticField.Z >= 0.0F ? -PI : PI));
+
+        orientationFilter.setYawReference(magnetometerYaw);
+    }
 
     // store sensor values for calculation of deviation
     float previousSensorPitch = sensorPitch;
     float previousSensorRoll = sensorRoll;
     float previousSensorYaw = sensorYaw;
 
-    // calculate sensor pitch, roll and yaw using complementary filter [rad]
-    const float SensorFilterFactor = 0.02F;
-    sensorPitch = (1.0F - SensorFilterFactor) * (sensorPitch + angularRate.Y * deltaT) + SensorFilterFactor * accelerometerPitch;
-    sensorRoll = (1.0F - SensorFilterFactor) * (sensorRoll + angularRate.X * deltaT) + SensorFilterFactor * accelerometerRoll;
-    sensorYaw = (1.0F - SensorFilterFactor) * (sensorYaw + angularRate.Z * deltaT) + SensorFilterFactor * magnetometerYaw;
+    // integrate all gyroscope and accelerometer samples drained from the IMU FIFO
+    for(uint8_t sample = 0; sample < sampleCount; sample++)
+    {
+        const uint8_t* sampleData = imuFrame.getSample(sample);
+        // parse IMU sensor data
+        parseImuSample(sampleData, gyroscopeData, accelerometerData);
+
+        // calculate IMU sensor physical values; using right hand rule
+        // X = roll axis = pointing North
+        // Y = pitch axis = pointing East
+        // Z = yaw axis = pointing down
+        // angular rate in rad/s
+        angularRate.X = -AngularRateResolution * static_cast<float>(gyroscopeData.Y);
+        angularRate.Y = -AngularRateResolution * static_cast<float>(gyroscopeData.Z);
+        angularRate.Z = AngularRateResolution * static_cast<float>(gyroscopeData.X);
+        // acceleration in g
+        acceleration.X = AccelerationResolution * static_cast<float>(accelerometerData.Z);
+        acceleration.Y = -AccelerationResolution * static_cast<float>(accelerometerData.Y);
+        acceleration.Z = -AccelerationResolution * static_cast<float>(accelerometerData.X);
+
+        orientationFilter.update(angularRate, acceleration, ImuSamplePeriod);
+    }
+
+    sensorPitch = orientationFilter.getPitch();
+    sensorRoll = orientationFilter.getRoll();
+    sensorYaw = orientationFilter.getYaw();
+    profiler.mark(HandlerStage::Fusion);
 
     // calculate sensor pitch, roll and yaw variability
     const float VariabilityFilterFactor = 0.01F;
@@ -236,16 +577,16 @@ void Yoke::handler()
     g_sensorYaw = sensorYaw;
 
     // calculate joystick pitch and roll depending on the joystick yaw [rad]
-    float sin2yaw = sin(sensorYaw) * fabs(sin(sensorYaw));
-    float cos2yaw = cos(sensorYaw) * fabs(cos(sensorYaw));
+    float sinYaw{0.0F};
+    float cosYaw{0.0F};
+    orientationFilter.getYawSinCos(sinYaw, cosYaw);
+    float sin2yaw = sinYaw * fabs(sinYaw);
+    float cos2yaw = cosYaw * fabs(cosYaw);
 
     float joystickPitch = calibratedSensorPitch * cos2yaw + calibratedSensorRoll * sin2yaw;
     float joystickRoll = calibratedSensorRoll * cos2yaw - calibratedSensorPitch * sin2yaw;
     float joystickYaw = calibratedSensorYaw;
 
-    // calculate joystick axes gain
-    joystickGainFilter.calculate(blueGrayPotentiometer.read() + 0.5F);  // range 0.5 .. 1.5     NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-
     float leftBrake{0.0F};
     float rightBrake{0.0F};
 
@@ -261,41 +602,137 @@ void Yoke::handler()
     else
     {
         // update pitch axis when not braking only
-        constexpr float MaxAngleY = 0.9F;   // [rad]
-        joystickData.Y = scale<float, int16_t>(-MaxAngleY, MaxAngleY, joystickPitch * joystickGainFilter.getValue(), -Max15bit, Max15bit);
+        joystickData.Y = scale<float, int16_t>(-maxAngleY, maxAngleY, joystickPitch * joystickGainFilter.getValue(), -Max15bit, Max15bit);
         // release brakes
         leftBrake = 0.0F;
         rightBrake = 0.0F;
     }
-    constexpr float MaxAngleX = 1.45F;   // [rad]
-    joystickData.X = scale<float, int16_t>(-MaxAngleX, MaxAngleX, joystickRoll * joystickGainFilter.getValue(), -Max15bit, Max15bit);
-    constexpr float MaxAngleZ = 0.78F;   // [rad]
-    joystickData.Rz = scale<float, int16_t>(-MaxAngleZ, MaxAngleZ, joystickYaw * joystickGainFilter.getValue(), -Max15bit, Max15bit);
-
-    throttleFilter.calculate(throttlePotentiometer.read());
-    throttleInput = throttleFilter.getValue();
-    const float ThrottleDeadZone = 0.03F;
-    joystickData.slider = scale<float, int16_t>(throttleInputMin + ThrottleDeadZone, throttleInputMax - ThrottleDeadZone, throttleInput, 0, Max15bit);
-
-    propellerFilter.calculate(propellerPotentiometer.read());
-    joystickData.dial = scale<float, int16_t>(0.0F, 1.0F, propellerFilter.getValue(), 0, Max15bit);
-
-    mixtureFilter.calculate(mixturePotentiometer.read());
-    joystickData.Z = scale<float, int16_t>(0.0F, 1.0F, mixtureFilter.getValue(), -Max15bit, Max15bit);
+    joystickData.X = scale<float, int16_t>(-maxAngleX, maxAngleX, joystickRoll * joystickGainFilter.getValue(), -Max15bit, Max15bit);
+    joystickData.Rz = scale<float, int16_t>(-maxAngleZ, maxAngleZ, joystickYaw * joystickGainFilter.getValue(), -Max15bit, Max15bit);
+#if MBED_CONF_APP_USB_REPORT_EXTRAPOLATION
+    setAxisRates(angularRate, sin2yaw, cos2yaw, brakeActive);
+#endif
     joystickData.Rx = scale<float, int16_t>(0.0F, 1.0F, leftBrake, 0, Max15bit);
     joystickData.Ry = scale<float, int16_t>(0.0F, 1.0F, rightBrake, 0, Max15bit);
+}
+#endif
 
-    // set joystick buttons
-    setJoystickButtons();
+/*
+* calculate the rates of change of the joystick X, Y and Rz axes for the report extrapolation [1/s]
+* the sensor angular rate is transformed in the same way as the sensor angles; the change of the yaw mixing factors is neglected
+*/
+void Yoke::setAxisRates(const Vector3D<float>& bodyAngularRate, float sin2yaw, float cos2yaw, bool brakeActive)
+{
+    float gain = joystickGainFilter.getValue() * static_cast<float>(Max15bit);
+    float pitchRate = bodyAngularRate.Y * cos2yaw + bodyAngularRate.X * sin2yaw;
+    float rollRate = bodyAngularRate.X * cos2yaw - bodyAngularRate.Y * sin2yaw;
+    axisRate.X = rollRate * gain / maxAngleX;
+    // pitch axis is frozen when braking
+    axisRate.Y = brakeActive ? 0.0F : pitchRate * gain / maxAngleY;
+    axisRate.Z = bodyAngularRate.Z * gain / maxAngleZ;
+}
 
-    usbJoystick.sendReport(joystickData);
+/*
+* send the joystick report at the USB poll rate
+* with the extrapolation enabled, the IMU axes are moved forward by the age of the IMU data
+*/
+void Yoke::sendScheduledReport()
+{
+    JoystickData report = joystickData;
+#if MBED_CONF_APP_USB_REPORT_EXTRAPOLATION
+    // the extrapolation is limited in case of missing IMU frames
+    constexpr float MaxExtrapolationTime = 0.02F;   // [s]
+    float age = std::min(static_cast<float>(getCycleCount() - reportInterruptTime) / static_cast<float>(SystemCoreClock), MaxExtrapolationTime);
+    auto extrapolate = [age](int16_t value, float rate)
+    {
+        return static_cast<int16_t>(limit<float>(static_cast<float>(value) + rate * age, -Max15bit, Max15bit));
+    };
+    report.X = extrapolate(report.X, axisRate.X);
+    report.Y = extrapolate(report.Y, axisRate.Y);
+    report.Rz = extrapolate(report.Rz, axisRate.Z);
+#endif
+    // one report is sent per USB poll
+    JoystickReportId reportId{JoystickReportId::Axes};
+    if(sendDueReport(report, reportId))
+    {
+        reportsSent++;
+        if((reportId == JoystickReportId::Axes) && isNewReportData)
+        {
+            // the first report with the data of a new IMU frame
+            latencyMonitor.add(reportInterruptTime, reportCompletionTime, reportDispatchTime, getCycleCount());
+            isNewReportData = false;
+        }
+    }
+}
 
-    // analog axis calibration on user request
-    axisCalibration();
+/*
+* pass one due joystick report to the USB device without waiting for the transfer
+* when both reports are due, they take turns, so a continuously changing report does not starve the other one
+* a suppression is counted only when no report is due
+* returns true if the report has been passed; reportId is the ID of this report
+*/
+bool Yoke::sendDueReport(JoystickData& report, JoystickReportId& reportId)
+{
+    bool isAxesReportDue = reportFilter.isReportDue(JoystickReportId::Axes, report);
+    bool isControlsReportDue = reportFilter.isReportDue(JoystickReportId::Controls, report);
+    if(!isAxesReportDue && !isControlsReportDue)
+    {
+        reportFilter.onReportSuppressed();
+        return false;
+    }
+    if(isAxesReportDue && isControlsReportDue)
+    {
+        reportId = (lastReportId == JoystickReportId::Axes) ? JoystickReportId::Controls : JoystickReportId::Axes;
+    }
+    else
+    {
+        reportId = isAxesReportDue ? JoystickReportId::Axes : JoystickReportId::Controls;
+    }
+    if(!usbJoystick.sendReportNonBlocking(reportId, report))
+    {
+        // the previous report has not been polled by the host yet
+        reportsBusy++;
+        return false;
+    }
+    reportFilter.onReportSent(reportId, report);
+    lastReportId = reportId;
+    return true;
+}
 
-    // LED heartbeat
-    constexpr uint32_t HeartbeatMask = 0x68U;
-    systemLed = (counter & HeartbeatMask) == HeartbeatMask ? 1U : 0;
+/*
+ * display and reset the handler stage profile
+ * the profile is copied in a critical section, so it is not modified by the IMU thread during display
+ */
+void Yoke::displayProfile(CommandVector&  /*cv*/)
+{
+    auto profile = [this]()
+    {
+        CriticalSectionLock lock;
+        auto snapshot = profiler;
+        profiler.reset();
+        return snapshot;
+    }();
+    std::cout << "yoke handler profile [CPU cycles at " << SystemCoreClock << " Hz]" << std::endl;
+    profile.display();
+}
+
+/*
+ * display and reset the IMU to USB report latency statistics
+ */
+void Yoke::displayLatency(CommandVector&  /*cv*/)
+{
+    auto latency = [this]()
+    {
+        CriticalSectionLock lock;
+        auto snapshot = latencyMonitor;
+        latencyMonitor.reset();
+        return snapshot;
+    }();
+    std::cout << "IMU data latency [CPU cycles at " << SystemCoreClock << " Hz]" << std::endl;
+    latency.display();
+    std::cout << "IMU frames skipped = " << imuAcquisition.getFramesSkipped() << std::endl;
+    std::cout << "IMU frames overwritten = " << imuAcquisition.getFramesOverwritten() << std::endl;
+    std::cout << "yoke handler overruns = " << handlerOverruns << std::endl;
 }
 
 /*
@@ -303,6 +740,15 @@ void Yoke::handler()
  */
 void Yoke::displayStatus(CommandVector&  /*cv*/)
 {
+#if MBED_CONF_APP_FIXED_POINT_PIPELINE
+    // the fixed-point pipeline keeps binary angles; convert them for display
+    sensorPitch = binaryAngleToRadians(sensorAngle.Y);
+    sensorRoll = binaryAngleToRadians(sensorAngle.X);
+    sensorYaw = binaryAngleToRadians(sensorAngle.Z);
+    sensorPitchReference = binaryAngleToRadians(sensorAngleReference.Y);
+    sensorRollReference = binaryAngleToRadians(sensorAngleReference.X);
+    sensorYawReference = binaryAngleToRadians(sensorAngleReference.Z);
+#endif
     std::cout << "yoke mode = " << modeTexts[static_cast<int>(yokeMode)] << std::endl;
     std::cout << "IMU sensor pitch/roll/yaw = " << sensorPitch << ", " << sensorRoll << ", " << sensorYaw << std::endl;
     std::cout << "reference pitch/roll/yaw = " << sensorPitchReference << ", " << sensorRollReference << ", " << sensorYawReference << std::endl;
@@ -317,66 +763,47 @@ void Yoke::displayStatus(CommandVector&  /*cv*/)
     std::cout << "joystick hat = 0x" << std::hex << std::setw(2) << std::setfill('0') << joystickData.hat << std::endl;
     std::cout << "joystick buttons = 0x" << std::hex << std::setw(8) << std::setfill('0') << joystickData.buttons << std::endl;     //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     std::cout << "throttle min/value/max = " << throttleInputMin << ", " << throttleInput << ", " << throttleInputMax << std::endl;
+#if MBED_CONF_APP_THROTTLE_FILTER_CUTOFF
+    std::cout << "throttle filter cutoff/sample rate = " << MBED_CONF_APP_THROTTLE_FILTER_CUTOFF << ", " << throttleSampleRate << " Hz" << std::endl;
+#endif
+#if MBED_CONF_APP_USB_REPORT_SCHEDULER
+    std::cout << "scheduled reports sent = " << std::dec << reportsSent << std::endl;
+#endif
+    std::cout << "USB reports sent/suppressed/busy = " << std::dec << reportFilter.getReportsSent() << ", " << reportFilter.getReportsSuppressed() << ", " << reportsBusy << std::endl;
 }
 
 /*
 set joystick buttons
 */
-void Yoke::setJoystickButtons()
+void Yoke::setJoystickButtons(const YokeInputs& inputs)
 {
-    auto setButton = [&](uint8_t input, uint8_t position)
-    {
-        if(input != 0)
-        {
-            joystickData.buttons &= ~(1 << position);       //NOLINT(hicpp-signed-bitwise)
-        }
-        else
-        {
-            joystickData.buttons |= 1 << position;          //NOLINT(hicpp-signed-bitwise)
-        }
-    };
-
-    joystickData.buttons = 0;
-
-    setButton(flapsUpSwitch.read(), 0);
-    setButton(flapsDownSwitch.read(), 1);
-    setButton(gearUpSwitch.read(), 2);
-    setButton(gearDownSwitch.read(), 3);
-    setButton(redPushbutton.read(), 4);
-    setButton(greenPushbutton.read(), 5);       //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    joystickData.buttons = SwitchButtonTable.map(inputs.switches);
 
     // set buttons from HAT switch
-    uint8_t hatPosition = hatSwitch.getPosition();
+    uint8_t hatPosition = inputs.hatPosition;
+    bool isHatCenterPressed = getLevel(inputs, SwitchInput::HatCenter) == 0;
 
     switch(hatMode)
     {
         case HatSwitchMode::FreeViewMode:
-            joystickData.hat = hatSwitch.getPosition();
-            setButton(hatCenterSwitch.read(), 10);          //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            joystickData.hat = hatPosition;
+            joystickData.buttons |= isHatCenterPressed ? (1U << 10) : 0;        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
             break;
         case HatSwitchMode::QuickViewMode:
             joystickData.hat = 0;
             if(hatPosition != 0)
             {
-                setButton(0, 15 + hatPosition); // set one button in the range 16-23    NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                joystickData.buttons |= 1U << (15 + hatPosition); // set one button in the range 16-23    NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
             }
-            setButton(hatCenterSwitch.read(), 24);      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            joystickData.buttons |= isHatCenterPressed ? (1U << 24) : 0;        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
             break;
         case HatSwitchMode::TrimMode:
             joystickData.hat = 0;
-            setButton(static_cast<uint8_t>(hatPosition != 1), 6); // elevator trim down     NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-            setButton(static_cast<uint8_t>(hatPosition != 5), 7); // elevator trim up       NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-            setButton(static_cast<uint8_t>(hatPosition != 3), 8); // rudder trim right      NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-            setButton(static_cast<uint8_t>(hatPosition != 7), 9); // rudder trim left       NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            joystickData.buttons |= TrimButtons[hatPosition];
             break;
         default:
             break;
     }
-
-    setButton(setSwitch.read(), 11);        //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-    setButton(resetSwitch.read(), 12);      //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-    setButton(reverserSwitch.read(), 13);   //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-    setButton(speedBrakeSwitch.read(), 14); //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 }
 
 /*
@@ -424,6 +851,11 @@ void Yoke::toggleAxisCalibration()
 
         KvStore::getInstance().store<float>("/kv/throttleInputMin", throttleInputMin);
         KvStore::getInstance().store<float>("/kv/throttleInputMax", throttleInputMax);
+#if MBED_CONF_APP_FIXED_POINT_PIPELINE
+        sensorPitchReference = binaryAngleToRadians(sensorAngleReference.Y);
+        sensorRollReference = binaryAngleToRadians(sensorAngleReference.X);
+        sensorYawReference = binaryAngleToRadians(sensorAngleReference.Z);
+#endif
         KvStore::getInstance().store<float>("/kv/sensorPitchRef", sensorPitchReference);
         KvStore::getInstance().store<float>("/kv/sensorRollRef", sensorRollReference);
         KvStore::getInstance().store<float>("/kv/sensorYawRef", sensorYawReference);
@@ -523,4 +955,158 @@ void Yoke::displayAll()
     Alarm::getInstance().displayOnScreen();
     displayMode();
     Menu::getInstance().displayItemText();
-}
\ No newline at end of file
+}
+#if MBED_CONF_APP_THROTTLE_FILTER_CUTOFF
+/*
+low-pass filter of the throttle potentiometer
+the filter is designed for the handler rate measured over the last MeasuredPeriods calls and designed again
+only when the measured rate differs from the design rate noticeably; the filter state is kept
+*/
+float Yoke::filterThrottle(float input, float deltaT)
+{
+    constexpr float CutoffFrequency = MBED_CONF_APP_THROTTLE_FILTER_CUTOFF;
+    constexpr uint32_t MeasuredPeriods = 128;
+    constexpr float MaxPeriod = 0.05F;              // longer periods of the missing IMU interrupts are not measured [s]
+    constexpr float MaxRateDeviation = 0.02F;       // relative deviation of the measured rate, which requires a new design
+    if(throttleSampleRate == 0.0F)
+    {
+        // the first design is for the nominal handler rate and the filter starts from the first input
+        throttleSampleRate = 1.0F / (ImuSamplePeriod * static_cast<float>(ImuFifoThreshold));
+        throttleLowPass.designLowPass(CutoffFrequency, throttleSampleRate);
+        throttleLowPass.reset(input);
+    }
+    if((deltaT > 0.0F) && (deltaT < MaxPeriod))
+    {
+        throttlePeriodSum += deltaT;
+        throttlePeriodCount++;
+    }
+    if(throttlePeriodCount == MeasuredPeriods)
+    {
+        float sampleRate = static_cast<float>(MeasuredPeriods) / throttlePeriodSum;
+        if(fabs(sampleRate - throttleSampleRate) > MaxRateDeviation * throttleSampleRate)
+        {
+            throttleSampleRate = sampleRate;
+            throttleLowPass.designLowPass(CutoffFrequency, throttleSampleRate);
+        }
+        throttlePeriodSum = 0.0F;
+        throttlePeriodCount = 0;
+    }
+    throttleLowPass.calculate(input);
+    return throttleLowPass.getValue();
+}
+#endif
+
+/*
+copy the current yoke parameters to the parameter report data (USB ISR context)
+the handler applies the host parameters in a critical section, so this interrupt never sees a mixed set of them
+*/
+void Yoke::readParameters(JoystickParameterData& data)
+{
+    YokeParameters parameters
+    {
+        maxAngleX,
+        maxAngleY,
+        maxAngleZ,
+        joystickGainFilter.getFactor(),
+        throttleFilter.getStrength(),
+        throttleInputMin,
+        throttleInputMax,
+        static_cast<uint32_t>(yokeMode)
+    };
+    std::memcpy(data.data(), &parameters, sizeof(parameters));
+}
+
+/*
+validate the yoke parameters written by the host and pass them to the handler (USB ISR context)
+returns false if any parameter is out of range; the current parameters are then kept unchanged
+*/
+bool Yoke::writeParameters(const JoystickParameterData& data)
+{
+    YokeParameters parameters{};
+    std::memcpy(&parameters, data.data(), sizeof(parameters));
+    auto isInRange = [](float value, float min, float max) { return (value >= min) && (value <= max); };     // false for NaN
+    constexpr float MinAngle = 0.1F;
+    constexpr float MinFilterFactor = 0.001F;      // the filter output would never follow the input with zero factor or strength
+    bool isValid = isInRange(parameters.maxAngleX, MinAngle, PI) &&
+        isInRange(parameters.maxAngleY, MinAngle, PI) &&
+        isInRange(parameters.maxAngleZ, MinAngle, PI) &&
+        isInRange(parameters.joystickGainFilterFactor, MinFilterFactor, 1.0F) &&
+        isInRange(parameters.potentiometerFilterStrength, MinFilterFactor, 1.0F) &&
+        isInRange(parameters.throttleInputMin, 0.0F, 0.49F) &&         //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        isInRange(parameters.throttleInputMax, 0.51F, 1.0F) &&         //NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        (parameters.yokeMode < static_cast<uint32_t>(YokeMode::Size));
+    if(isValid)
+    {
+        pendingParameters = parameters;
+        core_util_atomic_store_bool(&isParameterUpdatePending, true);
+    }
+    return isValid;
+}
+
+/*
+apply the parameters written by the host; called at the start of the handler, so one handler call never mixes
+the old and new parameters
+the parameters are applied in a critical section, so the parameter report read in the USB interrupt is consistent;
+the log and the display update are deferred to the menu thread, because the console output may block
+*/
+void Yoke::applyParameters()
+{
+    {
+        CriticalSectionLock lock;
+        const YokeParameters& parameters = pendingParameters;
+        maxAngleX = parameters.maxAngleX;
+        maxAngleY = parameters.maxAngleY;
+        maxAngleZ = parameters.maxAngleZ;
+        joystickGainFilter.setFactor(parameters.joystickGainFilterFactor);
+        throttleFilter.setStrength(parameters.potentiometerFilterStrength);
+        mixtureFilter.setStrength(parameters.potentiometerFilterStrength);
+        propellerFilter.setStrength(parameters.potentiometerFilterStrength);
+        throttleInputMin = parameters.throttleInputMin;
+        throttleInputMax = parameters.throttleInputMax;
+        yokeMode = static_cast<YokeMode>(parameters.yokeMode);
+        isParameterUpdatePending = false;
+    }
+    Menu::getInstance().defer(callback(this, &Yoke::reportParameterUpdate));
+}
+
+/*
+log the parameter update by the host and display the yoke mode, which the host may have changed (menu thread)
+*/
+void Yoke::reportParameterUpdate()
+{
+    LOG_INFO("yoke parameters updated by the host");
+    if(Menu::getInstance().isDisplayEnabled())
+    {
+        // the stopwatch occupies the display; the mode is displayed again when the stopwatch is closed
+        displayMode();
+    }
+}
+
+/*
+* reset the filters and the sensor fusion state to the state after power-up
+* called in the IMU thread at the start of the replay, so the replayed records are processed from the same initial state
+* the calibration references and the yoke parameters are kept
+*/
+void Yoke::resetProcessing()
+{
+#if MBED_CONF_APP_FIXED_POINT_PIPELINE
+    fixedPointFusion.reset();
+    sensorAngle = {0, 0, 0};
+    sensorAngleVariability = {0, 0, 0};
+#else
+    orientationFilter.reset();
+#endif
+    sensorPitch = sensorRoll = sensorYaw = 0.0F;
+    sensorPitchVariability = sensorRollVariability = sensorYawVariability = 0.0F;
+    joystickGainFilter.reset();
+    throttleFilter.reset();
+    mixtureFilter.reset();
+    propellerFilter.reset();
+#if MBED_CONF_APP_THROTTLE_FILTER_CUTOFF
+    // the throttle filter is designed and started from the next input again
+    throttleSampleRate = 0.0F;
+    throttlePeriodSum = 0.0F;
+    throttlePeriodCount = 0;
+#endif
+    axisRate = {0.0F, 0.0F, 0.0F};
+}
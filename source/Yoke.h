@@ -2,15 +2,22 @@
 #define YOKE_H_
 
 #include "USBJoystick.h"
+#include "AnalogAcquisition.h"
 #include "Console.h"
 #include "Filter.h"
+#include "FixedPoint.h"
 #include "I2CDevice.h"
+#include "ImuAcquisition.h"
+#include "Orientation.h"
+#include "Profiler.h"
+#include "Recorder.h"
+#include "ReportFilter.h"
 #include "Switch.h"
 #include <mbed.h>
 
 #define USB_VID     0x0483 //STElectronics
 #define USB_PID     0x5711 //joystick in FS mode + 1
-#define USB_VER     0x0001 //Nucleo Yoke IMU ver. 1
+#define USB_VER     0x0002 //Nucleo Yoke IMU ver. 2: composite HID + CDC-ACM device; the new release makes the hosts enumerate the new interfaces
 
 #define I2C2_SCL    PF_1
 #define I2C2_SDA    PF_0
@@ -21,37 +28,61 @@
 #define LSM9DS1_M_ADD   0x3C
 #define LSM9DS1_INT1    PD_1
 
-template<typename T> struct Vector3D    //NOLINT(altera-struct-pack-align)
+// orientation engine selected with the orientation-filter parameter in mbed_app.json
+#if MBED_CONF_APP_ORIENTATION_FILTER == 1
+using OrientationFilter = MahonyFilter;
+#else
+using OrientationFilter = ComplementaryFilter;
+#endif
 
+enum struct HatSwitchMode
 {
-    T X;
-    T Y;
-    T Z;
+    FreeViewMode,
+    QuickViewMode,
+    TrimMode
 };
 
-enum struct LSM6DS3reg : uint8_t
+// stages of the yoke handler measured by the cycle profiler
+enum struct HandlerStage : size_t
 {
-    INT1_CTRL = 0x0D,
-    CTRL1_XL = 0x10,
-    CTRL7_G = 0x16,
-    OUT_X_L_G = 0x22,
+    Acquisition,        // I2C acquisition of the IMU frame from the IMU interrupt to the last transfer completion
+    Fusion,             // IMU frame readout and sensor fusion
+    AxisScaling,        // joystick axes calculation
+    Buttons,            // joystick buttons and HAT switch
+    Report,             // USB HID report sending
+    Calibration,        // analog axis calibration
+    Size
 };
 
-enum struct LSM9DS1reg : uint8_t
+// potentiometers in the order of the yoke input readings
+enum struct Potentiometer : size_t
 {
-    INT1_CTRL = 0x0C,
-    CTRL_REG1_G = 0x10,
-    OUT_X_L_G = 0x18,
-    CTRL_REG6_XL = 0x20,
-    CTRL_REG1_M = 0x20,
-    OUT_X_L_M = 0x28
+    Throttle,
+    Propeller,
+    Mixture,
+    Orange,
+    Yellow,
+    BlueGray
 };
 
-enum struct HatSwitchMode
+// switch inputs in the order of the yoke input bitmap
+enum struct SwitchInput : uint16_t
 {
-    FreeViewMode,
-    QuickViewMode,
-    TrimMode
+    FlapsUp,
+    FlapsDown,
+    GearUp,
+    GearDown,
+    RedPushbutton,
+    GreenPushbutton,
+    HatCenter,
+    Set,
+    Reset,
+    Reverser,
+    SpeedBrake,
+    HatModeToggle,
+    ViewModeToggle,
+    HatModeShift,
+    Size
 };
 
 enum struct YokeMode
@@ -61,22 +92,56 @@ enum struct YokeMode
     Size
 };
 
+// tunable yoke parameters in the data of the USB parameter feature report (little-endian)
+struct YokeParameters     //NOLINT(altera-struct-pack-align)
+{
+    float maxAngleX;                    // joystick roll angle at full X axis deflection [rad]
+    float maxAngleY;                    // joystick pitch angle at full Y axis deflection [rad]
+    float maxAngleZ;                    // joystick yaw angle at full Rz axis deflection [rad]
+    float joystickGainFilterFactor;     // EMA factor of the joystick gain potentiometer
+    float potentiometerFilterStrength;  // AEMA strength of the throttle, mixture and propeller potentiometers
+    float throttleInputMin;
+    float throttleInputMax;
+    uint32_t yokeMode;                  // YokeMode value
+};
+static_assert(sizeof(YokeParameters) == JoystickParameterDataSize, "yoke parameters do not match the parameter report data size");
+
 class Yoke
 {
 public:
-    explicit Yoke(events::EventQueue& eventQueue);
+    Yoke();
     void displayStatus(CommandVector& cv);
     void displayAll();
+    void displayProfile(CommandVector& cv);
+    void displayLatency(CommandVector& cv);
 private:
-    void imuInterruptHandler() { eventQueue.call(callback(this, &Yoke::handler)); }
+    void imuInterruptHandler() { imuAcquisition.start(); }
+    void imuTimeoutHandler();
+    void imuThreadHandler();
+    void reportTickerHandler() { imuThread.flags_set(ReportFlag); }
     void handler();
-    void setJoystickButtons();
+    void setAxisRates(const Vector3D<float>& bodyAngularRate, float sin2yaw, float cos2yaw, bool brakeActive);
+    void sendScheduledReport();
+    bool sendDueReport(JoystickData& report, JoystickReportId& reportId);
+    void calculateImuAxes(const ImuFrame& imuFrame, uint8_t sampleCount, bool isMagnetometerFresh, float deltaT, bool brakeActive);
+    void readInputs(YokeInputs& inputs);
+    static uint8_t getLevel(const YokeInputs& inputs, SwitchInput input) { return (inputs.switches >> static_cast<uint16_t>(input)) & 1U; }     //NOLINT(hicpp-signed-bitwise)
+    static float getPotentiometer(const YokeInputs& inputs, Potentiometer potentiometer) { return inputs.potentiometers[static_cast<size_t>(potentiometer)]; }
+    void setJoystickButtons(const YokeInputs& inputs);
     void axisCalibration();
     void toggleAxisCalibration();
     void toggleStopwatch();
     void displayMode();
     void displayStopwatch();
-    events::EventQueue& eventQueue;     // event queue of the main thread
+    void readParameters(JoystickParameterData& data);
+    bool writeParameters(const JoystickParameterData& data);
+    void applyParameters();
+    void reportParameterUpdate();
+    void resetProcessing();
+#if MBED_CONF_APP_THROTTLE_FILTER_CUTOFF
+    float filterThrottle(float input, float deltaT);
+#endif
+    Thread imuThread;                   // high priority thread of the IMU acquisition and the yoke handler
     DigitalOut systemLed;               // yoke heartbeat LED
     uint32_t counter{0};                // counter of handler execution
     USBJoystick usbJoystick;            // USB HID joystick device
@@ -84,8 +149,25 @@ private:
     I2C i2cBus;                         // I2C bus for IMU sensor
     I2CDevice sensorGA;                 // IMU gyroscope and accelerometer sensor
     I2CDevice sensorM;                  // magnetometer sensor
+    ImuAcquisition imuAcquisition;      // non-blocking acquisition of IMU sensor data
     Timeout imuIntTimeout;              // timeout of the IMU sensor interrupts
     Timer handlerTimer;                 // measures handler call period
+    CycleProfiler<HandlerStage, static_cast<size_t>(HandlerStage::Size)> profiler;     // handler stage execution times
+    LatencyMonitor latencyMonitor;      // IMU interrupt to USB report latency
+    uint32_t handlerOverruns{0};        // IMU interrupts received while the handler was still processing the previous frame
+    Recorder recorder;                  // recorder and replay of the sensor data and yoke inputs
+    static constexpr uint32_t NoImuInterruptFlag = 0x100U;     // IMU thread flag of the missing IMU interrupt
+    static constexpr uint32_t ReportFlag = 0x200U;             // IMU thread flag of the scheduled USB report
+    Ticker reportTicker;                // USB report scheduler at the USB poll rate
+    Vector3D<float> axisRate{0.0F, 0.0F, 0.0F};     // rate of change of the joystick X, Y and Rz axes for the report extrapolation [1/s]
+    uint32_t reportInterruptTime{0};    // IMU interrupt time of the frame of the current joystick data
+    uint32_t reportCompletionTime{0};   // transfer completion time of the frame of the current joystick data
+    uint32_t reportDispatchTime{0};     // handler start time of the frame of the current joystick data
+    bool isNewReportData{false};        // the joystick data has not been sent by the scheduler yet
+    uint32_t reportsSent{0};            // reports sent by the scheduler
+    uint32_t reportsBusy{0};            // due reports not sent, because the previous report was still pending
+    JoystickReportId lastReportId{JoystickReportId::Axes};     // the last sent report; the other one goes first when both are due
+    ReportFilter reportFilter;          // axis hysteresis and suppression of the unchanged reports
     Vector3D<int16_t> gyroscopeData{0};    // raw data from gyroscope
     Vector3D<int16_t> accelerometerData{0};    // raw data from accelerometer
     Vector3D<int16_t> magnetometerData{0}; // raw data from magnetometer
@@ -93,36 +175,31 @@ private:
     Vector3D<float>  acceleration{0.0F};      // measured IMU sensor acceleration in g
     Vector3D<float>  magneticField{0.0F};     // measured magnetometer sensor magnetic field in gauss
     static constexpr float PI = 3.14159265359F;
+    static constexpr float ImuSamplePeriod = 1.0F / 476.0F;    // gyroscope and accelerometer ODR=476 Hz
+    static constexpr uint8_t ImuFifoThreshold = 4;      // IMU FIFO watermark level; sets the handler call rate to 119 Hz
     static constexpr int16_t Max15bit = 0x7FFF;     // maximum 15-bit number (32767)
+    float maxAngleX{1.45F};     // joystick roll angle at full X axis deflection [rad]
+    float maxAngleY{0.9F};      // joystick pitch angle at full Y axis deflection [rad]
+    float maxAngleZ{0.78F};     // joystick yaw angle at full Rz axis deflection [rad]
+    YokeParameters pendingParameters{};     // parameters written by the host, applied at the start of the next handler call
+    bool isParameterUpdatePending{false};   // the pending parameters have not been applied yet
     const float AngularRateResolution = 500.0F * PI / 180.0F / 32768.0F;   // 1-bit resolution of angular rate in rad/s
     const float AccelerationResolution = 2.0F / 32768.0F;   // 1-bit resolution of acceleration in g
     const float MagneticFieldResolution = 16.0F / 32768.0F;   // 1-bit resolution of magnetic field in gauss
+#if MBED_CONF_APP_FIXED_POINT_PIPELINE
+    FixedPointFusion<int16_t> fixedPointFusion;     // fixed-point IMU sensor orientation engine
+    Vector3D<int32_t> sensorAngle{0, 0, 0};                 // orientation of the IMU sensor (binary angles: roll, pitch, yaw)
+    Vector3D<int32_t> sensorAngleVariability{0, 0, 0};      // filtered orientation change per handler call (binary angles)
+    Vector3D<int32_t> sensorAngleReference{0, 0, 0};        // reference orientation of the IMU sensor (binary angles)
+#else
+    OrientationFilter orientationFilter;    // IMU sensor orientation engine
+#endif
     float sensorPitch{0.0F}, sensorRoll{0.0F}, sensorYaw{0.0F};             // orientation of the IMU sensor
     float sensorPitchVariability{0.0F}, sensorRollVariability{0.0F}, sensorYawVariability{0.0F};
     float sensorPitchReference, sensorRollReference, sensorYawReference;
     DigitalOut calibrationLed;
     JoystickData joystickData{0};
-    DigitalIn flapsUpSwitch;
-    DigitalIn flapsDownSwitch;
-    DigitalIn gearUpSwitch;
-    DigitalIn gearDownSwitch;
-    DigitalIn redPushbutton;
-    DigitalIn greenPushbutton;
-    DigitalIn hatCenterSwitch;
-    DigitalIn setSwitch;
-    DigitalIn resetSwitch;
-    DigitalIn reverserSwitch;
-    DigitalIn speedBrakeSwitch;
-    DigitalIn hatModeToggle;
-    DigitalIn viewModeToggle;
-    DigitalIn hatModeShift;
-    AnalogIn throttlePotentiometer;
-    AnalogIn propellerPotentiometer;
-    AnalogIn mixturePotentiometer;
-    AnalogIn orangePotentiometer;
-    AnalogIn yellowPotentiometer;
-    AnalogIn blueGrayPotentiometer;
-    Hat hatSwitch;
+    AnalogAcquisition potentiometers;   // background acquisition of the potentiometers in the Potentiometer order
     HatSwitchMode hatMode{HatSwitchMode::TrimMode};
     FilterEMA joystickGainFilter;
     YokeMode yokeMode;
@@ -136,6 +213,12 @@ private:
     FilterAEMA throttleFilter;
     FilterAEMA mixtureFilter;
     FilterAEMA propellerFilter;
+#if MBED_CONF_APP_THROTTLE_FILTER_CUTOFF
+    FilterBiquad<2> throttleLowPass;        // 4th order low-pass filter of the throttle potentiometer
+    float throttleSampleRate{0.0F};         // handler rate of the throttle filter design [Hz]
+    float throttlePeriodSum{0.0F};          // sum of the measured handler periods [s]
+    uint32_t throttlePeriodCount{0};        // number of the measured handler periods
+#endif
     const std::vector<const std::string> modeTexts =
     {
         "fixed-wing",
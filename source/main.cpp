@@ -16,6 +16,7 @@
 
 #include "Yoke.h"
 #include "Alarm.h"
+#include "Benchmark.h"
 #include "Console.h"
 #include "Display.h"
 #include "Logger.h"
@@ -30,6 +31,7 @@ int main()
     HAL_DBGMCU_EnableDBGSleepMode();
 #endif
     logTimer.start();        //start timer for log purposes
+    enableCycleCounter();    // the cycle counter runs freely from here; the benchmarks and time stamps take differences only
     LOG_ALWAYS("Nucleo Yoke IMU v1.1");
 
     // create and start console thread
@@ -39,21 +41,21 @@ int main()
     // register some console commands
     Console::getInstance().registerCommand("h", "help (display command list)", callback(&Console::getInstance(), &Console::displayHelp));
     Console::getInstance().registerCommand("lt", "list threads", callback(listThreads));
+    Console::getInstance().registerCommand("bo", "benchmark orientation filters", callback(benchmarkOrientation));
+    Console::getInstance().registerCommand("bf", "benchmark fixed-point fusion", callback(benchmarkFixedPoint));
+    Console::getInstance().registerCommand("bs", "benchmark smoothing filters", callback(benchmarkFilters));
 
     // init display
     Display::getInstance().init();
 
-    // main event queue
-    events::EventQueue eventQueue;
-
-    // create Yoke object
-    Yoke yoke(eventQueue);
+    // create Yoke object; the yoke handler runs in its own IMU thread
+    Yoke yoke;
 
     // shaw all fields on pilot's display
     yoke.displayAll();
 
-    // process the event queue
-    eventQueue.dispatch_forever();
+    // the main thread keeps the yoke object alive
+    ThisThread::sleep_for(Kernel::wait_for_u32_forever);
 
     return 0;
 }